@@ -0,0 +1,207 @@
+// Requires threads and POSIX write(). Compiles to nothing elsewhere, e.g. on microcontrollers.
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "AtomicRingBuffer/AsyncLogger.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+uint64_t nextLoggerId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+constexpr std::size_t AsyncLogger::kRecordHeaderSize;
+
+constexpr std::size_t AsyncLogger::kMessagesPerTurn;
+
+thread_local AsyncLogger::ThreadCache AsyncLogger::tlsCache;
+thread_local AsyncLogger::ThreadProducers AsyncLogger::tlsProducers;
+
+AsyncLogger::ThreadProducers::~ThreadProducers() {
+  tlsCache = ThreadCache();
+  for (const std::pair<uint64_t, std::shared_ptr<Producer>> &entry : producers) {
+    // Releases the messages of the thread to the drainer, which frees the producer after writing them.
+    entry.second->abandoned.store(true, std::memory_order_release);
+  }
+}
+
+AsyncLogger::AsyncLogger(const int fd, const Options &options)
+    : fd_(fd), options_(options), id_(nextLoggerId()), batch_(options.batchSize) {
+  drainer_ = std::thread(&AsyncLogger::drainLoop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+  {
+    std::lock_guard<std::mutex> lock(stopMutex_);
+    stop_ = true;
+  }
+  stopCondition_.notify_one();
+  drainer_.join();
+
+  std::lock_guard<std::mutex> drainLock(drainMutex_);
+  drain();
+  writeBatch();
+
+  std::lock_guard<std::mutex> producersLock(producersMutex_);
+  for (const std::shared_ptr<Producer> &producer : producers_) {
+    producer->detached.store(true, std::memory_order_relaxed);
+  }
+}
+
+std::size_t AsyncLogger::numThreads() const {
+  std::lock_guard<std::mutex> lock(producersMutex_);
+  return producers_.size();
+}
+
+void AsyncLogger::flush() {
+  std::lock_guard<std::mutex> lock(drainMutex_);
+  drain();
+  writeBatch();
+}
+
+AsyncLogger::Producer &AsyncLogger::registerThread() {
+  std::vector<std::pair<uint64_t, std::shared_ptr<Producer>>> &own = tlsProducers.producers;
+  Producer *producer = nullptr;
+  for (const std::pair<uint64_t, std::shared_ptr<Producer>> &entry : own) {
+    if (entry.first == id_) {
+      producer = entry.second.get();
+      break;
+    }
+  }
+
+  if (producer == nullptr) {
+    // Forget the producers of destroyed loggers.
+    own.erase(std::remove_if(own.begin(), own.end(),
+                             [](const std::pair<uint64_t, std::shared_ptr<Producer>> &entry) {
+                               return entry.second->detached.load(std::memory_order_relaxed);
+                             }),
+              own.end());
+
+    std::shared_ptr<Producer> created = std::make_shared<Producer>(options_.bytesPerThread);
+    {
+      std::lock_guard<std::mutex> lock(producersMutex_);
+      producers_.push_back(created);
+    }
+    producer = created.get();
+    own.emplace_back(id_, std::move(created));
+  }
+
+  tlsCache.loggerId = id_;
+  tlsCache.producer = producer;
+  return *producer;
+}
+
+void AsyncLogger::drainLoop() {
+  while (true) {
+    bool drained;
+    {
+      std::lock_guard<std::mutex> lock(drainMutex_);
+      drained = drain();
+      writeBatch();
+    }
+
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    if (!drained) {
+      stopCondition_.wait_for(lock, options_.pollInterval, [this]() { return stop_; });
+    }
+    if (stop_) {
+      return;
+    }
+  }
+}
+
+bool AsyncLogger::drain() {
+  // Only drain() removes producers, and it runs under drainMutex_, so they stay valid without holding the lock.
+  std::vector<Producer *> producers;
+  {
+    std::lock_guard<std::mutex> lock(producersMutex_);
+    producers.reserve(producers_.size());
+    for (const std::shared_ptr<Producer> &producer : producers_) {
+      producers.push_back(producer.get());
+    }
+  }
+
+  bool drained = false;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (Producer *producer : producers) {
+      for (std::size_t i = 0; i < kMessagesPerTurn; ++i) {
+        const Ring::MessageView message = producer->ring.tryRead();
+        if (message.ptr == nullptr) {
+          break;
+        }
+        appendRecord(message.ptr, message.len);
+        producer->ring.consume(message);
+        progress = true;
+      }
+    }
+    drained |= progress;
+  }
+
+  std::lock_guard<std::mutex> lock(producersMutex_);
+  producers_.erase(std::remove_if(producers_.begin(), producers_.end(),
+                                  [](const std::shared_ptr<Producer> &producer) {
+                                    // Checking abandoned first makes all messages of the thread visible.
+                                    return producer->abandoned.load(std::memory_order_acquire) &&
+                                           producer->ring.empty();
+                                  }),
+                   producers_.end());
+  return drained;
+}
+
+void AsyncLogger::appendRecord(const uint8_t *record, const std::size_t len) {
+  if (len < kRecordHeaderSize) {
+    return;
+  }
+  detail::LogFormatFunction formatFunction;
+  const char *format;
+  memcpy(&formatFunction, record, sizeof(formatFunction));
+  memcpy(&format, record + sizeof(formatFunction), sizeof(format));
+  const uint8_t *args = record + kRecordHeaderSize;
+
+  int textLen = formatFunction(batch_.data() + batchLen_, batch_.size() - batchLen_, format, args);
+  if (textLen < 0) {
+    return;
+  }
+  // snprintf() needs room for the null character, which is not written.
+  if (static_cast<std::size_t>(textLen) >= batch_.size() - batchLen_ && batchLen_ != 0) {
+    writeBatch();
+    textLen = formatFunction(batch_.data(), batch_.size(), format, args);
+    if (textLen < 0) {
+      return;
+    }
+  }
+  // A message that does not fit into an empty batch is truncated.
+  batchLen_ += std::min(static_cast<std::size_t>(textLen), batch_.size() - batchLen_ - 1);
+}
+
+void AsyncLogger::writeBatch() {
+  std::size_t written = 0;
+  while (written < batchLen_) {
+    const ssize_t result = ::write(fd_, batch_.data() + written, batchLen_ - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // Nothing can be reported from here, so the rest of the batch is lost.
+      break;
+    }
+    numWrites_.fetch_add(1, std::memory_order_relaxed);
+    written += static_cast<std::size_t>(result);
+  }
+  batchLen_ = 0;
+}
+
+}  // namespace AtomicRingBuffer
+
+#endif  // defined(__unix__) || defined(__APPLE__)
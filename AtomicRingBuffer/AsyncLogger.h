@@ -0,0 +1,327 @@
+#ifndef __ATOMICRINGBUFFER__ASYNCLOGGER_H__
+#define __ATOMICRINGBUFFER__ASYNCLOGGER_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MessageRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+namespace detail {
+
+/**
+ * \brief Binary encoding of a log argument of type T.
+ *
+ * Arithmetic types, enums and pointers are copied as they are. Strings are copied including the terminating null
+ * character, so they can be passed to the formatter in place. A null string is encoded as "(null)".
+ */
+template <typename T>
+struct LogArg {
+  static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                "Only arithmetic types, enums, pointers and strings can be logged.");
+
+  using decoded_type = T;
+
+  static std::size_t size(const T &) { return sizeof(T); }
+
+  static uint8_t *encode(uint8_t *out, const T &value) {
+    memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+
+  static T decode(const uint8_t *&in) {
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+};
+
+template <>
+struct LogArg<const char *> {
+  using decoded_type = const char *;
+
+  static std::size_t size(const char *value) { return sizeof(uint32_t) + strlen(orNullText(value)) + 1; }
+
+  static uint8_t *encode(uint8_t *out, const char *value) {
+    const char *text = orNullText(value);
+    return encodeString(out, text, strlen(text));
+  }
+
+  static const char *decode(const uint8_t *&in) {
+    uint32_t len;
+    memcpy(&len, in, sizeof(len));
+    const char *value = reinterpret_cast<const char *>(in + sizeof(len));
+    in += sizeof(len) + len + 1;
+    return value;
+  }
+
+  static uint8_t *encodeString(uint8_t *out, const char *value, const std::size_t len) {
+    const uint32_t encodedLen = static_cast<uint32_t>(len);
+    memcpy(out, &encodedLen, sizeof(encodedLen));
+    memcpy(out + sizeof(encodedLen), value, len);
+    out[sizeof(encodedLen) + len] = '\0';
+    return out + sizeof(encodedLen) + len + 1;
+  }
+
+  static const char *orNullText(const char *value) { return (value != nullptr) ? value : "(null)"; }
+};
+
+template <>
+struct LogArg<char *> : public LogArg<const char *> {};
+
+template <>
+struct LogArg<std::string> : public LogArg<const char *> {
+  static std::size_t size(const std::string &value) { return sizeof(uint32_t) + value.size() + 1; }
+
+  static uint8_t *encode(uint8_t *out, const std::string &value) {
+    return encodeString(out, value.data(), value.size());
+  }
+};
+
+/**
+ * \brief Formats a record with arguments of types Args with snprintf().
+ *
+ * \return The return value of snprintf(): The length of the complete text, which may exceed outLen.
+ */
+using LogFormatFunction = int (*)(char *out, std::size_t outLen, const char *format, const uint8_t *args);
+
+template <typename... Args>
+struct LogFormatter {
+  static int format(char *out, const std::size_t outLen, const char *format, const uint8_t *args) {
+    return formatDecoded(out, outLen, format, args, std::index_sequence_for<Args...>{});
+  }
+
+  template <std::size_t... I>
+  static int formatDecoded(char *out, const std::size_t outLen, const char *format, const uint8_t *args,
+                           std::index_sequence<I...>) {
+    // Braced initialization decodes the arguments from left to right.
+    const std::tuple<typename LogArg<Args>::decoded_type...> values{LogArg<Args>::decode(args)...};
+    (void)args;
+    // The trailing 0 is ignored by snprintf(). It keeps the format from being the only argument, which compilers warn
+    // about for formats that are not literals.
+    return snprintf(out, outLen, format, std::get<I>(values)..., 0);
+  }
+};
+
+}  // namespace detail
+
+/**
+ * \brief Writes printf-style log messages to a file descriptor from a background thread.
+ *
+ * log() encodes the format string pointer and the arguments into a ring buffer of the calling thread and returns. It
+ * neither formats nor takes a lock, except for the first message of a thread to a logger, which creates the ring buffer
+ * and registers it with the logger. A thread that logs to several loggers finds its ring buffers without a lock. A
+ * drainer thread formats the messages of all threads into a large batch and writes it with as few write() calls as
+ * possible:
+ *
+ *     AsyncLogger logger(STDERR_FILENO);
+ *     logger.log("request %u took %.3f ms from %s\n", id, elapsedMs, clientName);
+ *
+ * The format string is stored as a pointer, so it must outlive the logger, e.g. a string literal. Strings passed as
+ * arguments are copied. Messages of one thread are written in order. The drainer takes turns between threads of up to
+ * kMessagesPerTurn messages each, so a busy thread does not hold back the messages of the others. If the ring buffer of
+ * a thread is full, log() drops the message and returns false. No thread may log while the logger is destroyed, or
+ * from destructors of thread_local objects.
+ *
+ * When a thread exits, its ring buffers are freed as soon as their messages have been written.
+ *
+ * Only available on UNIX. Requires AtomicRingBuffer/AsyncLogger.cpp.
+ */
+class AsyncLogger {
+ public:
+  /// Messages the drainer takes from one thread before moving on to the next.
+  constexpr static std::size_t kMessagesPerTurn = 64;
+
+  struct Options {
+    /// Bytes of ring buffer per logging thread.
+    std::size_t bytesPerThread = 64 * 1024;
+
+    /// Bytes of formatted text collected before calling write(). Longer messages are truncated. Must not be 0.
+    std::size_t batchSize = 64 * 1024;
+
+    /// How long the drainer sleeps when no thread has logged anything.
+    std::chrono::microseconds pollInterval{1000};
+  };
+
+  explicit AsyncLogger(int fd) : AsyncLogger(fd, Options()) {}
+
+  /**
+   * \brief Start the drainer thread, which writes to fd. The logger does not take ownership of fd.
+   */
+  AsyncLogger(int fd, const Options &options);
+
+  /**
+   * \brief Stop the drainer thread after writing all messages logged so far.
+   */
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  /**
+   * \brief Queue a message for formatting with snprintf(format, args...).
+   *
+   * \return Whether the message was queued.
+   */
+  template <typename... Args>
+  bool log(const char *format, const Args &... args) {
+    using Formatter = detail::LogFormatter<typename std::decay<Args>::type...>;
+
+    const std::size_t len = kRecordHeaderSize + argsSize(args...);
+    Producer &producer = threadProducer();
+    const Ring::MemoryRange payload = producer.ring.reserve(len);
+    if (payload.ptr == nullptr) {
+      numDropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    const detail::LogFormatFunction formatFunction = &Formatter::format;
+    memcpy(payload.ptr, &formatFunction, sizeof(formatFunction));
+    memcpy(payload.ptr + sizeof(formatFunction), &format, sizeof(format));
+    encodeArgs(payload.ptr + kRecordHeaderSize, args...);
+    return producer.ring.commit(payload);
+  }
+
+  /**
+   * \brief Write all messages logged so far before returning.
+   */
+  void flush();
+
+  /**
+   * \brief Number of messages dropped because the ring buffer of the logging thread was full.
+   */
+  uint64_t numDropped() const { return numDropped_.load(std::memory_order_relaxed); }
+
+  /**
+   * \brief Number of successful write() calls made so far.
+   */
+  uint64_t numWrites() const { return numWrites_.load(std::memory_order_relaxed); }
+
+  /**
+   * \brief Number of ring buffers held for logging threads, including those of exited threads that are not drained yet.
+   */
+  std::size_t numThreads() const;
+
+ private:
+  using Ring = BasicMessageRingBuffer<SpscTraits>;
+
+  constexpr static std::size_t kRecordHeaderSize = sizeof(detail::LogFormatFunction) + sizeof(const char *);
+
+  /**
+   * \brief The ring buffer of one thread for one logger. Shared by both, so it lives until the thread has exited and
+   * the drainer has written its messages, or until the logger is destroyed and the thread has forgotten it.
+   */
+  struct Producer {
+    explicit Producer(const std::size_t len) : storage(new uint32_t[(len + 3) / 4]) {
+      ring.init(reinterpret_cast<uint8_t *>(storage.get()), len);
+    }
+
+    std::unique_ptr<uint32_t[]> storage;
+    Ring ring;
+
+    // Set when the thread has exited. The drainer then removes the producer once it is empty.
+    std::atomic<bool> abandoned{false};
+
+    // Set when the logger has been destroyed. The thread then drops the producer when it registers its next one.
+    std::atomic<bool> detached{false};
+  };
+
+  /**
+   * \brief The producers of a thread, one per logger it has logged to. Abandons them when the thread exits.
+   */
+  struct ThreadProducers {
+    ~ThreadProducers();
+
+    std::vector<std::pair<uint64_t, std::shared_ptr<Producer>>> producers;
+  };
+
+  static std::size_t argsSize() { return 0; }
+
+  template <typename Arg, typename... Rest>
+  static std::size_t argsSize(const Arg &arg, const Rest &... rest) {
+    return detail::LogArg<typename std::decay<Arg>::type>::size(arg) + argsSize(rest...);
+  }
+
+  static void encodeArgs(uint8_t *) {}
+
+  template <typename Arg, typename... Rest>
+  static void encodeArgs(uint8_t *out, const Arg &arg, const Rest &... rest) {
+    encodeArgs(detail::LogArg<typename std::decay<Arg>::type>::encode(out, arg), rest...);
+  }
+
+  /**
+   * \brief The ring buffer of the calling thread, which is created on first use. The fast path only checks whether the
+   * thread logged to this logger last.
+   */
+  Producer &threadProducer() {
+    if (tlsCache.loggerId == id_) {
+      return *tlsCache.producer;
+    }
+    return registerThread();
+  }
+
+  /**
+   * \brief Find the producer of the calling thread in its thread-local list, or create and register one.
+   */
+  Producer &registerThread();
+
+  void drainLoop();
+
+  /**
+   * \brief Format and write all messages that are available, taking turns between producers, then remove the producers
+   * of exited threads that are empty. Must be called with drainMutex_ held.
+   *
+   * \return Whether there were any messages.
+   */
+  bool drain();
+
+  void appendRecord(const uint8_t *record, std::size_t len);
+  void writeBatch();
+
+  // Remembers the producer of the logger that the calling thread logged to last.
+  struct ThreadCache {
+    uint64_t loggerId = 0;
+    Producer *producer = nullptr;
+  };
+  static thread_local ThreadCache tlsCache;
+  static thread_local ThreadProducers tlsProducers;
+
+  const int fd_;
+  const Options options_;
+  // Unique across all loggers, so that a thread never uses the cached producer of a destroyed logger.
+  const uint64_t id_;
+
+  mutable std::mutex producersMutex_;
+  std::vector<std::shared_ptr<Producer>> producers_;
+
+  std::mutex drainMutex_;
+  std::vector<char> batch_;
+  std::size_t batchLen_ = 0;
+
+  // Wakes the drainer when the logger is destroyed.
+  std::mutex stopMutex_;
+  std::condition_variable stopCondition_;
+  bool stop_ = false;
+
+  std::atomic<uint64_t> numDropped_{0};
+  std::atomic<uint64_t> numWrites_{0};
+  std::thread drainer_;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__ASYNCLOGGER_H__
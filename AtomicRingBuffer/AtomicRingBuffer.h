@@ -4,9 +4,232 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
+
+#include "CompletionMap.h"
+#include "Lease.h"
+#include "Statistics.h"
+#include "Trace.h"
 
 namespace AtomicRingBuffer {
 
+/**
+ * \brief Assumed size of a cache line in bytes.
+ *
+ * std::hardware_destructive_interference_size is not available in C++14 and its value is not ABI-stable, so a
+ * conservative default is used instead. Override by defining ATOMICRINGBUFFER_CACHE_LINE_SIZE.
+ */
+#ifdef ATOMICRINGBUFFER_CACHE_LINE_SIZE
+constexpr std::size_t kCacheLineSize = ATOMICRINGBUFFER_CACHE_LINE_SIZE;
+#else
+constexpr std::size_t kCacheLineSize = 64;
+#endif
+
+/**
+ * \brief Index synchronization that tolerates concurrent callers on the same side.
+ *
+ * Indices are updated using compare_exchange_strong, so concurrent operations spuriously fail instead of corrupting
+ * the buffer.
+ */
+struct TolerantSynchronization {
+  /// Whether multiple producers may allocate and publish concurrently.
+  static constexpr bool kMultiProducer = false;
+
+  /// Load an index that is written by the calling side.
+  static std::size_t loadOwn(const std::atomic_size_t &idx) { return idx.load(); }
+
+  /// Load an index that is written by the other side.
+  static std::size_t loadOther(const std::atomic_size_t &idx) { return idx.load(); }
+
+  /// Move an index that is only read by the calling side. Returns false if the index was modified concurrently.
+  static bool reserve(std::atomic_size_t &idx, std::size_t expected, const std::size_t desired) {
+    return idx.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+  }
+
+  /// Move an index that is only read by the calling side back to return reserved space. Unlike reserve(), which may
+  /// be retried, this must only fail if the index was modified concurrently.
+  static bool unreserve(std::atomic_size_t &idx, std::size_t expected, const std::size_t desired) {
+    return idx.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+  }
+
+  /// Move an index that is read by the other side. Returns false if the index was modified concurrently.
+  static bool update(std::atomic_size_t &idx, std::size_t expected, const std::size_t desired) {
+    return idx.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+  }
+};
+
+/**
+ * \brief Index synchronization for exactly one producer thread and exactly one consumer thread.
+ *
+ * Each index is only ever written by its owner, so updates are plain stores. Publishing an index uses release
+ * semantics, loading the index of the other side uses acquire semantics and everything else is relaxed.
+ */
+struct SpscSynchronization {
+  static constexpr bool kMultiProducer = false;
+
+  static std::size_t loadOwn(const std::atomic_size_t &idx) { return idx.load(std::memory_order_relaxed); }
+
+  static std::size_t loadOther(const std::atomic_size_t &idx) { return idx.load(std::memory_order_acquire); }
+
+  static bool reserve(std::atomic_size_t &idx, std::size_t, const std::size_t desired) {
+    idx.store(desired, std::memory_order_relaxed);
+    return true;
+  }
+
+  static bool unreserve(std::atomic_size_t &idx, std::size_t, const std::size_t desired) {
+    idx.store(desired, std::memory_order_relaxed);
+    return true;
+  }
+
+  static bool update(std::atomic_size_t &idx, std::size_t, const std::size_t desired) {
+    idx.store(desired, std::memory_order_release);
+    return true;
+  }
+};
+
+/**
+ * \brief Index synchronization for multiple concurrent producer threads and exactly one consumer thread.
+ *
+ * Producers reserve disjoint ranges by retrying compare-and-swap on the allocate index. Publishing records the
+ * published bytes in a completion map, which allows publishing out of order. The write index advances as soon as a
+ * contiguous range following it has been published. The consumer side works as with SpscSynchronization.
+ */
+struct MultiProducerSynchronization {
+  static constexpr bool kMultiProducer = true;
+
+  static std::size_t loadOwn(const std::atomic_size_t &idx) { return idx.load(std::memory_order_relaxed); }
+
+  static std::size_t loadOther(const std::atomic_size_t &idx) { return idx.load(std::memory_order_acquire); }
+
+  static bool reserve(std::atomic_size_t &idx, std::size_t expected, const std::size_t desired) {
+    return idx.compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_relaxed);
+  }
+
+  // A spurious failure would make shrink() fail for the most recent allocation, so this must be strong.
+  static bool unreserve(std::atomic_size_t &idx, std::size_t expected, const std::size_t desired) {
+    return idx.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_relaxed);
+  }
+
+  static bool update(std::atomic_size_t &idx, std::size_t, const std::size_t desired) {
+    idx.store(desired, std::memory_order_release);
+    return true;
+  }
+};
+
+/**
+ * \brief Compile-time configuration of a BasicAtomicRingBuffer.
+ *
+ * To change a setting, derive from DefaultTraits and shadow the respective member.
+ */
+struct DefaultTraits {
+  /**
+   * Alignment of the three groups of members: The immutable buffer description, the producer-owned indices and the
+   * consumer-owned indices. The default packs all members as tightly as possible.
+   */
+  static constexpr std::size_t kIndexAlignment = alignof(std::atomic_size_t);
+
+  /**
+   * Whether the producer keeps a private copy of the read index and the consumer a private copy of the write index.
+   * The shared index of the other side is only loaded when the private copy indicates insufficient space or data. This
+   * avoids most cross-core cache misses in steady state, but requires that only one thread at a time acts as producer
+   * and one thread at a time acts as consumer.
+   */
+  static constexpr bool kCacheOppositeIndex = false;
+
+  /**
+   * How indices are loaded and updated. One of TolerantSynchronization, SpscSynchronization or
+   * MultiProducerSynchronization.
+   */
+  using Synchronization = TolerantSynchronization;
+
+  /**
+   * Whether the bufferSize bytes following the buffer map the same physical memory as the buffer itself, e.g. when
+   * using MirroredMemory. allocate() and peek() then hand out ranges that run past the end of the buffer into the
+   * mirror, so they are only limited by the free space or the available data.
+   */
+  static constexpr bool kMirroredBuffer = false;
+
+  /**
+   * Which operations are counted. NoStatistics or CountingStatistics, see BasicAtomicRingBuffer::statistics().
+   */
+  using Statistics = NoStatistics;
+
+  /**
+   * Whether operations are recorded in the TraceLog. NoTracing or EventTracing.
+   */
+  using Tracing = NoTracing;
+};
+
+/**
+ * \brief Places buffer description, producer indices and consumer indices on separate cache lines.
+ *
+ * Avoids false sharing between a producer and a consumer running on different cores at the cost of a larger object.
+ * Note that before C++17, operator new does not respect the alignment of over-aligned types.
+ */
+struct CacheAlignedTraits : public DefaultTraits {
+  static constexpr std::size_t kIndexAlignment = kCacheLineSize;
+};
+
+/**
+ * \brief Producer and consumer only load the index of the other side when running out of space or data.
+ */
+struct CachedIndexTraits : public DefaultTraits {
+  static constexpr bool kCacheOppositeIndex = true;
+};
+
+/**
+ * \brief Uses plain loads and stores with minimal memory ordering instead of compare-and-swap.
+ *
+ * Requires that there is exactly one producer thread and exactly one consumer thread.
+ */
+struct SpscTraits : public DefaultTraits {
+  using Synchronization = SpscSynchronization;
+};
+
+/**
+ * \brief Lets multiple producer threads allocate and publish concurrently. Requires exactly one consumer thread.
+ */
+struct MultiProducerTraits : public DefaultTraits {
+  using Synchronization = MultiProducerSynchronization;
+};
+
+/**
+ * \brief Hands out contiguous ranges across the end of the buffer. Requires a buffer backed by MirroredMemory.
+ */
+struct MirroredTraits : public DefaultTraits {
+  static constexpr bool kMirroredBuffer = true;
+};
+
+namespace detail {
+constexpr auto min(const std::size_t left, const std::size_t right) -> std::size_t {
+  return (left > right) ? right : left;
+}
+}  // namespace detail
+
+namespace detail {
+/**
+ * \brief Whether more than one thread at a time may act on the same side of a buffer with these traits.
+ *
+ * Tolerant synchronization allows concurrent callers on the same side unless the opposite index is cached.
+ */
+template <typename Traits>
+struct ConcurrentSides {
+  static constexpr bool kConsumer =
+      std::is_same<typename Traits::Synchronization, TolerantSynchronization>::value && !Traits::kCacheOppositeIndex;
+  static constexpr bool kProducer = Traits::Synchronization::kMultiProducer || kConsumer;
+};
+
+template <typename Traits>
+using StatisticsCountersFor =
+    StatisticsCounters<Traits::Statistics::kCountOperations, ConcurrentSides<Traits>::kProducer,
+                       ConcurrentSides<Traits>::kConsumer, kCacheLineSize>;
+
+template <typename Traits>
+using OccupancyCountersFor = OccupancyCounters<Traits::Statistics::kTrackHighWaterMark,
+                                               Traits::Statistics::kSampleFillLevel, ConcurrentSides<Traits>::kProducer,
+                                               kCacheLineSize>;
+}  // namespace detail
+
 /**
  * \brief Manages a round-robin buffer of bytes.
  *
@@ -18,13 +241,27 @@ namespace AtomicRingBuffer {
  *   full or empty.
  * * Class invariant: When adjusting for the circular nature of the index range (2*bufferSize_), it holds that:
  *   readIdx <= writeIdx <= allocateIdx.
+ * * With MultiProducerSynchronization, the bytes between writeIdx and allocateIdx that have already been published and
+ *   the bytes between readIdx and writeIdx are marked in the completion map.
  */
-class AtomicRingBuffer {
+template <typename Traits = DefaultTraits>
+class BasicAtomicRingBuffer : private detail::CompletionMap<Traits::Synchronization::kMultiProducer>,
+                              private detail::StatisticsCountersFor<Traits>,
+                              private detail::OccupancyCountersFor<Traits> {
+  using CompletionMap_t = detail::CompletionMap<Traits::Synchronization::kMultiProducer>;
+  using Operation = detail::Operation;
+
  public:
   using value_type = uint8_t;
   using pointer_type = value_type *;
   using size_type = std::size_t;
   using atomic_size_type = std::atomic_size_t;
+  using traits_type = Traits;
+  using Sync = typename Traits::Synchronization;
+  using completion_word_type = typename CompletionMap_t::word_type;
+
+  static_assert(!(Traits::kCacheOppositeIndex && Sync::kMultiProducer),
+                "Multiple producers cannot share a cached read index.");
 
   struct MemoryRange {
     pointer_type ptr = nullptr;
@@ -33,16 +270,59 @@ class AtomicRingBuffer {
     bool operator==(const MemoryRange &other) const { return ptr == other.ptr && len == other.len; }
   };
 
-  constexpr AtomicRingBuffer() : buffer_(nullptr), bufferSize_(0) {}
-  constexpr AtomicRingBuffer(pointer_type buf, size_type len) : buffer_(buf), bufferSize_(len) {}
+  /**
+   * \brief Up to two contiguous ranges of bytes. If the bytes wrap around the end of the buffer, second starts at the
+   * beginning of the buffer.
+   */
+  struct MemoryRangePair {
+    MemoryRange first;
+    MemoryRange second;
+
+    size_type len() const { return first.len + second.len; }
+
+    bool operator==(const MemoryRangePair &other) const { return first == other.first && second == other.second; }
+  };
+
+  constexpr BasicAtomicRingBuffer() : buffer_(nullptr), bufferSize_(0) {}
+
+  /**
+   * \brief Use len bytes at buf. Not available with MultiProducerSynchronization, which requires a completion map.
+   */
+  template <typename S = Sync, typename std::enable_if<!S::kMultiProducer, int>::type = 0>
+  constexpr BasicAtomicRingBuffer(pointer_type buf, size_type len) : buffer_(buf), bufferSize_(len) {}
+
+  /**
+   * \brief Use len bytes at buf, see init(pointer_type, size_type, completion_word_type *).
+   */
+  BasicAtomicRingBuffer(pointer_type buf, size_type len, completion_word_type *completionMap)
+      : buffer_(buf), bufferSize_(len) {
+    this->initCompletionMap(completionMap, completionMapSize(len));
+  }
 
+  /**
+   * \brief Initialize a buffer. Not available with MultiProducerSynchronization, which requires a completion map.
+   */
+  template <typename S = Sync, typename std::enable_if<!S::kMultiProducer, int>::type = 0>
   void init(pointer_type buf, const size_type len) {
-    buffer_ = buf;
-    bufferSize_ = len;
+    initIndices(buf, len);
+  }
 
-    writeIdx_ = 0;
-    allocateIdx_ = 0;
-    readIdx_ = 0;
+  /**
+   * \brief Number of words of completion map required for a buffer of len bytes.
+   */
+  constexpr static size_type completionMapSize(const size_type len) {
+    return detail::CompletionMap<true>::numWords(len);
+  }
+
+  /**
+   * \brief Initialize a buffer using MultiProducerSynchronization.
+   *
+   * \param completionMap Storage for completionMapSize(len) words that records out-of-order publishes. Ignored by
+   * other synchronization policies.
+   */
+  void init(pointer_type buf, const size_type len, completion_word_type *completionMap) {
+    initIndices(buf, len);
+    this->initCompletionMap(completionMap, completionMapSize(len));
   }
 
   /**
@@ -56,51 +336,134 @@ class AtomicRingBuffer {
   /**
    * Sends of allocated bytes. Can send parts of an allocaton but cannot send
    * out-of-order. Cannot send bytes wrapping around the buffer.
+   *
+   * With MultiProducerSynchronization, allocations can be published out of order. Published data becomes visible to
+   * the consumer once all allocations before it have been published as well.
    */
-  size_type publish(const MemoryRange data) { return commit(writeIdx_, allocateIdx_, data); }
+  size_type publish(const MemoryRange data) {
+    if (Sync::kMultiProducer) {
+      return publishOutOfOrder(data);
+    } else {
+      return commit(writeIdx_, Sync::loadOwn(allocateIdx_), data);
+    }
+  }
 
   /**
-   * Returns pointer and length to available data.
+   * \brief Get as many elements as requested, continuing at the beginning of the buffer if necessary.
+   *
+   * Like allocate(), but the allocation may wrap around the end of the buffer. The allocated space is reserved with a
+   * single index update and can be published with a single call to publish(const MemoryRangePair).
    */
-  MemoryRange peek(const size_type len, const bool partial_acceptable) const {
-    return allocate(readIdx_, writeIdx_, true, len, partial_acceptable);
+  MemoryRangePair allocateSegments(const size_type numElems, const bool partial_acceptable);
+
+  /**
+   * \brief Publish both ranges of an allocation made by allocateSegments() with a single index update.
+   *
+   * The second range is only published if the first range reaches the end of the buffer and is published completely.
+   */
+  size_type publish(const MemoryRangePair data) {
+    if (Sync::kMultiProducer) {
+      return publishOutOfOrder(data);
+    } else {
+      return commit(writeIdx_, Sync::loadOwn(allocateIdx_), data);
+    }
   }
 
+  /**
+   * Returns pointer and length to available data.
+   */
+  MemoryRange peek(const size_type len, const bool partial_acceptable) const;
+
+  /**
+   * \brief Returns up to len bytes of available data, continuing at the beginning of the buffer if necessary.
+   */
+  MemoryRangePair peekSegments(const size_type len, const bool partial_acceptable) const;
+
   /**
    * Free up space in the buffer.
+   *
+   * When caching the opposite index, only bytes that have previously been peeked can be consumed.
    */
-  size_type consume(const MemoryRange data) { return commit(readIdx_, writeIdx_, data); }
+  size_type consume(const MemoryRange data) {
+    return commit(readIdx_, (Traits::kCacheOppositeIndex ? cachedWriteIdx_ : Sync::loadOther(writeIdx_)), data);
+  }
 
-  size_type capacity() const { return bufferSize_; }
+  /**
+   * \brief Free up both ranges obtained from peekSegments() with a single index update.
+   */
+  size_type consume(const MemoryRangePair data) {
+    return commit(readIdx_, (Traits::kCacheOppositeIndex ? cachedWriteIdx_ : Sync::loadOther(writeIdx_)), data);
+  }
 
-  size_type size() const {
-    size_type bytesAvailable = 0;
-    size_type currentReadIdx = readIdx_;
-    size_type currentWriteIdx = writeIdx_;
-    if (currentWriteIdx >= currentReadIdx) {
-      bytesAvailable = currentWriteIdx - currentReadIdx;
-    } else {
-      bytesAvailable = bytesRemainingInBuffer(currentReadIdx);
-      bytesAvailable += wrapToBufferSize(currentWriteIdx);
-    }
+  /**
+   * \brief Return the end of the most recent allocation to the buffer, keeping its first len bytes.
+   *
+   * Must be called before the allocation is published.
+   *
+   * \return Whether the allocation was shrunk. Fails if another allocation has been made since.
+   */
+  bool shrink(const MemoryRange allocation, const size_type len);
 
-    return bytesAvailable;
+  /**
+   * \brief Like allocate(), but the allocation is published when the returned lease goes out of scope.
+   */
+  WriteLease<BasicAtomicRingBuffer> allocateLease(const size_type numElems, const bool partial_acceptable) {
+    return WriteLease<BasicAtomicRingBuffer>(*this, allocate(numElems, partial_acceptable));
+  }
+
+  /**
+   * \brief Like peek(), but the data is consumed when the returned lease goes out of scope.
+   */
+  ReadLease<BasicAtomicRingBuffer> peekLease(const size_type len, const bool partial_acceptable) {
+    return ReadLease<BasicAtomicRingBuffer>(*this, peek(len, partial_acceptable));
   }
 
+  size_type capacity() const { return bufferSize_; }
+
+  size_type size() const { return distance(readIdx_.load(), writeIdx_.load()); }
+
   bool empty() const { return readIdx_ == writeIdx_; }
 
+  /**
+   * \brief Counters of all operations and occupancy since init() or resetStatistics().
+   *
+   * Only the statistics selected by Traits::Statistics are recorded, all others are zero. Can be called from any
+   * thread.
+   */
+  BufferStatistics statistics() const {
+    BufferStatistics statistics;
+    this->snapshotOperations(statistics);
+    this->snapshotOccupancy(statistics);
+    return statistics;
+  }
+
+  /**
+   * \brief Set all counters to zero. Must not be called concurrently with other operations.
+   */
+  void resetStatistics() {
+    this->resetOperations();
+    this->resetOccupancy();
+  }
+
  private:
+  void initIndices(pointer_type buf, const size_type len) {
+    buffer_ = buf;
+    bufferSize_ = len;
+
+    writeIdx_ = 0;
+    allocateIdx_ = 0;
+    readIdx_ = 0;
+
+    cachedReadIdx_ = 0;
+    cachedWriteIdx_ = 0;
+
+    resetStatistics();
+  }
+
   constexpr size_type beginIdx() const { return 0; }
   constexpr size_type endIdx() const { return bufferSize_; }
   constexpr size_type upperSectionEndIdx() const { return 2 * bufferSize_; }
 
-  constexpr size_type wrapToBufferSize(size_type idx) const {
-    if (idx > bufferSize_) {
-      idx -= bufferSize_;
-    }
-    return idx;
-  }
-
   constexpr size_type wrapToBufferIdx(size_type idx) const {
     if (idx >= bufferSize_) {
       idx -= bufferSize_;
@@ -120,6 +483,34 @@ class AtomicRingBuffer {
     return bytesToPointerOrBufferEnd(lower, upper, true);
   }
 
+  /**
+   * \brief Number of contiguous bytes that can be handed out starting at lower.
+   *
+   * For isInside, these are the bytes from lower to upper. Otherwise, these are the bytes from lower to upper in the
+   * next round of the buffer. Unless the buffer is mirrored, the range is cut off at the end of the buffer.
+   */
+  size_type contiguousBytes(const size_type lower, const size_type upper, bool isInside) const {
+    if (Traits::kMirroredBuffer) {
+      return isInside ? distance(lower, upper) : bufferSize_ - distance(upper, lower);
+    } else {
+      return bytesToPointerOrBufferEnd(lower, upper, isInside);
+    }
+  }
+
+  /**
+   * \brief Mark or clear len bytes starting at idx in the completion map, splitting the range at the end of the buffer.
+   */
+  void markCompletedSegments(const size_type idx, const size_type len) {
+    const MemoryRangePair segments = toSegments(idx, len);
+    this->markCompleted(wrapToBufferIdx(idx), segments.first.len);
+    this->markCompleted(0, segments.second.len);
+  }
+  void clearCompletedSegments(const size_type idx, const size_type len) {
+    const MemoryRangePair segments = toSegments(idx, len);
+    this->clearCompleted(wrapToBufferIdx(idx), segments.first.len);
+    this->clearCompleted(0, segments.second.len);
+  }
+
   constexpr size_type bytesRemainingInBuffer(const size_type idx) const {
     if (idxInUpperSection(idx)) {
       return upperSectionEndIdx() - idx;
@@ -130,7 +521,91 @@ class AtomicRingBuffer {
 
   MemoryRange allocate(const size_type sectionBegin, const size_type sectionEnd, const bool isInside,
                        const size_type len, const bool partial_acceptable) const;
-  size_type commit(atomic_size_type &sectionBegin, atomic_size_type &sectionEnd, const MemoryRange data);
+  size_type commit(atomic_size_type &sectionBegin, const size_type sectionEnd, const MemoryRange data);
+  size_type commit(atomic_size_type &sectionBegin, const size_type sectionEnd, const MemoryRangePair data);
+
+  /**
+   * \brief Split len bytes starting at idx into the part before and the part after the end of the buffer.
+   */
+  MemoryRangePair toSegments(const size_type idx, const size_type len) const {
+    MemoryRangePair segments;
+    if (len > 0) {
+      const size_type startIdx = wrapToBufferIdx(idx);
+      segments.first.ptr = &buffer_[startIdx];
+      segments.first.len = detail::min(len, endIdx() - startIdx);
+      if (segments.first.len < len) {
+        segments.second.ptr = buffer_;
+        segments.second.len = len - segments.first.len;
+      }
+    }
+    return segments;
+  }
+
+  /**
+   * \brief Number of bytes of data that can be committed as one piece, starting at the beginning of data.first.
+   */
+  size_type contiguousLen(const MemoryRangePair &data) const {
+    const size_type firstIdx = data.first.ptr - buffer_;
+    const size_type firstLen = detail::min(data.first.len, endIdx() - firstIdx);
+    if (firstIdx + firstLen == endIdx() && data.first.len == firstLen && data.second.ptr == buffer_) {
+      return firstLen + data.second.len;
+    }
+    return firstLen;
+  }
+
+  size_type publishOutOfOrder(const MemoryRange data);
+  size_type publishOutOfOrder(const MemoryRangePair data);
+
+  /**
+   * \brief Whether commit() on sectionBegin publishes or consumes.
+   */
+  Operation commitOperation(const atomic_size_type &sectionBegin) const {
+    return (&sectionBegin == &writeIdx_) ? Operation::kPublish : Operation::kConsume;
+  }
+
+  /**
+   * \brief Count and trace an operation on len bytes starting at ptr.
+   */
+  void recordSuccess(const Operation op, const value_type *ptr, const size_type len) const {
+    this->countSuccess(op, len);
+    detail::Tracer<Traits::Tracing::kEnabled>::record(this, op, static_cast<size_type>(ptr - buffer_), len);
+  }
+
+  /**
+   * \brief Sample the fill level after an allocation up to newAllocateIdx. A cached read index may be outdated and
+   * overstate the fill level, so the read index is then loaded afresh. Does nothing unless occupancy is tracked.
+   */
+  void sampleAllocation(const size_type currentReadIdx, const size_type newAllocateIdx) const {
+    if (Traits::Statistics::kTrackHighWaterMark || Traits::Statistics::kSampleFillLevel) {
+      const size_type readIdx = Traits::kCacheOppositeIndex ? Sync::loadOther(readIdx_) : currentReadIdx;
+      this->sampleFillLevel(distance(readIdx, newAllocateIdx), bufferSize_);
+    }
+  }
+
+  void countPeek(const value_type *ptr, const size_type len) const {
+    if (len != 0) {
+      recordSuccess(Operation::kPeek, ptr, len);
+    } else {
+      this->countRejected(Operation::kPeek);
+    }
+  }
+
+  /**
+   * \brief Validate data and mark it as published in the completion map. Does not advance writeIdx_.
+   */
+  size_type markPublished(const MemoryRange data);
+
+  /**
+   * \brief Move writeIdx_ past all bytes following it that are marked as published.
+   */
+  void advanceWriteIdx();
+
+  /**
+   * \brief Number of bytes from lower to upper, which may be up to bufferSize_ ahead.
+   */
+  constexpr size_type distance(const size_type lower, const size_type upper) const {
+    return (upper >= lower) ? upper - lower : upper + upperSectionEndIdx() - lower;
+  }
 
   /**
    * \brief Whether a pointer points to the lower or the upper round of the buffer
@@ -143,19 +618,395 @@ class AtomicRingBuffer {
     return idxInUpperSection(lower) == idxInUpperSection(upper);
   }
 
-  pointer_type buffer_;
+  // Immutable after init(), read by both sides.
+  alignas(Traits::kIndexAlignment) alignas(pointer_type) pointer_type buffer_;
   size_type bufferSize_;
 
+  // Producer-owned indices.
+
   // Until where can be read
-  atomic_size_type writeIdx_{0};
+  alignas(Traits::kIndexAlignment) atomic_size_type writeIdx_{0};
 
   // Until where elements have been allocated
   atomic_size_type allocateIdx_{0};
 
+  // Last value of readIdx_ seen by the producer. Only used when caching the opposite index.
+  size_type cachedReadIdx_{0};
+
+  // Consumer-owned indices.
+
   // From where can be read
-  atomic_size_type readIdx_{0};
+  alignas(Traits::kIndexAlignment) atomic_size_type readIdx_{0};
+
+  // Last value of writeIdx_ seen by the consumer. Only used when caching the opposite index.
+  mutable size_type cachedWriteIdx_{0};
 };
 
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::bytesToPointerOrBufferEnd(
+    const size_type lower, const size_type upper, bool isInside) const {
+  size_type bytesAvailable = bytesRemainingInBuffer(lower);
+  size_type upperBytesUsed = bytesRemainingInBuffer(upper);
+
+  // Figure out whether the memory managed by upper eats into the bytesAvailable
+  if ((upperBytesUsed < bytesAvailable) ||
+      (!isInside && upperBytesUsed == bytesAvailable && !sameSection(lower, upper)) || (isInside && lower == upper)) {
+    bytesAvailable -= upperBytesUsed;
+  }
+  return bytesAvailable;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::MemoryRange BasicAtomicRingBuffer<Traits>::allocate(size_type numElems,
+                                                                                           bool partial_acceptable) {
+  MemoryRange allocatedMemory;
+  bool reserved = false;
+  size_type currentReadIdx = 0;
+  size_type newAllocateIdx = 0;
+  do {
+    // Find how many bytes can be allocated
+    size_type origAllocateIdx = Sync::loadOwn(allocateIdx_);
+    if (Traits::kCacheOppositeIndex) {
+      allocatedMemory = allocate(origAllocateIdx, cachedReadIdx_, false, numElems, partial_acceptable);
+      if (allocatedMemory.len < numElems) {
+        // The cached index may be outdated. Only now look at what the consumer has freed up in the meantime.
+        cachedReadIdx_ = Sync::loadOther(readIdx_);
+        allocatedMemory = allocate(origAllocateIdx, cachedReadIdx_, false, numElems, partial_acceptable);
+      }
+      currentReadIdx = cachedReadIdx_;
+    } else {
+      currentReadIdx = Sync::loadOther(readIdx_);
+      allocatedMemory = allocate(origAllocateIdx, currentReadIdx, false, numElems, partial_acceptable);
+    }
+
+    // Make the allocation
+    newAllocateIdx = origAllocateIdx + allocatedMemory.len;
+    newAllocateIdx = wrapToDoubleBufferIdx(newAllocateIdx);
+
+    reserved = (newAllocateIdx != origAllocateIdx && Sync::reserve(allocateIdx_, origAllocateIdx, newAllocateIdx));
+    if (!reserved && allocatedMemory.len != 0) {
+      this->countCasFailure(Operation::kAllocate);
+    }
+    // Multiple producers retry until they either run out of space or win the race.
+  } while (Sync::kMultiProducer && !reserved && allocatedMemory.len != 0);
+
+  if (!reserved) {
+    if (allocatedMemory.len == 0) {
+      this->countRejected(Operation::kAllocate);
+    }
+    allocatedMemory.ptr = nullptr;
+    allocatedMemory.len = 0;
+  } else {
+    recordSuccess(Operation::kAllocate, allocatedMemory.ptr, allocatedMemory.len);
+    sampleAllocation(currentReadIdx, newAllocateIdx);
+  }
+  return allocatedMemory;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::MemoryRangePair BasicAtomicRingBuffer<Traits>::allocateSegments(
+    const size_type numElems, const bool partial_acceptable) {
+  MemoryRangePair allocatedMemory;
+  bool reserved = false;
+  size_type currentReadIdx = 0;
+  size_type newAllocateIdx = 0;
+  do {
+    size_type origAllocateIdx = Sync::loadOwn(allocateIdx_);
+    if (Traits::kCacheOppositeIndex) {
+      if (bufferSize_ - distance(cachedReadIdx_, origAllocateIdx) < numElems) {
+        cachedReadIdx_ = Sync::loadOther(readIdx_);
+      }
+      currentReadIdx = cachedReadIdx_;
+    } else {
+      currentReadIdx = Sync::loadOther(readIdx_);
+    }
+    const size_type numFreeElems = bufferSize_ - distance(currentReadIdx, origAllocateIdx);
+
+    if (numFreeElems < numElems && !partial_acceptable) {
+      this->countRejected(Operation::kAllocate);
+      return MemoryRangePair{};
+    }
+    const size_type numAllocatedElems = detail::min(numElems, numFreeElems);
+    allocatedMemory = toSegments(origAllocateIdx, numAllocatedElems);
+
+    newAllocateIdx = wrapToDoubleBufferIdx(origAllocateIdx + numAllocatedElems);
+    reserved = (numAllocatedElems != 0 && Sync::reserve(allocateIdx_, origAllocateIdx, newAllocateIdx));
+    if (!reserved && numAllocatedElems != 0) {
+      this->countCasFailure(Operation::kAllocate);
+    }
+  } while (Sync::kMultiProducer && !reserved && allocatedMemory.len() != 0);
+
+  if (!reserved) {
+    if (allocatedMemory.len() == 0) {
+      this->countRejected(Operation::kAllocate);
+    }
+    allocatedMemory = MemoryRangePair{};
+  } else {
+    recordSuccess(Operation::kAllocate, allocatedMemory.first.ptr, allocatedMemory.len());
+    sampleAllocation(currentReadIdx, newAllocateIdx);
+  }
+  return allocatedMemory;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::MemoryRangePair BasicAtomicRingBuffer<Traits>::peekSegments(
+    const size_type len, const bool partial_acceptable) const {
+  const size_type currentReadIdx = Sync::loadOwn(readIdx_);
+  size_type numAvailableElems = 0;
+  if (Traits::kCacheOppositeIndex) {
+    numAvailableElems = distance(currentReadIdx, cachedWriteIdx_);
+    if (numAvailableElems < len) {
+      cachedWriteIdx_ = Sync::loadOther(writeIdx_);
+      numAvailableElems = distance(currentReadIdx, cachedWriteIdx_);
+    }
+  } else {
+    numAvailableElems = distance(currentReadIdx, Sync::loadOther(writeIdx_));
+  }
+
+  const size_type numPeekedElems =
+      (numAvailableElems < len && !partial_acceptable) ? 0 : detail::min(len, numAvailableElems);
+  const MemoryRangePair segments = toSegments(currentReadIdx, numPeekedElems);
+  countPeek(segments.first.ptr, numPeekedElems);
+  return segments;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::MemoryRange BasicAtomicRingBuffer<Traits>::peek(
+    const size_type len, const bool partial_acceptable) const {
+  const size_type currentReadIdx = Sync::loadOwn(readIdx_);
+  MemoryRange memory;
+  if (Traits::kCacheOppositeIndex) {
+    memory = allocate(currentReadIdx, cachedWriteIdx_, true, len, partial_acceptable);
+    if (memory.len < len) {
+      // The cached index may be outdated. Only now look at what the producer has published in the meantime.
+      cachedWriteIdx_ = Sync::loadOther(writeIdx_);
+      memory = allocate(currentReadIdx, cachedWriteIdx_, true, len, partial_acceptable);
+    }
+  } else {
+    memory = allocate(currentReadIdx, Sync::loadOther(writeIdx_), true, len, partial_acceptable);
+  }
+  countPeek(memory.ptr, memory.len);
+  return memory;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::MemoryRange BasicAtomicRingBuffer<Traits>::allocate(
+    const size_type sectionBegin, const size_type sectionEnd, const bool isInside, const size_type len,
+    const bool partial_acceptable) const {
+  MemoryRange memory;
+  size_type dataAvailable = contiguousBytes(sectionBegin, sectionEnd, isInside);
+
+  if (dataAvailable != 0) {
+    size_type dataStartIdx = wrapToBufferIdx(sectionBegin);
+    if (dataAvailable >= len || partial_acceptable) {
+      memory.len = detail::min(len, dataAvailable);
+      memory.ptr = &buffer_[dataStartIdx];
+    }
+  }
+  return memory;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::commit(
+    atomic_size_type &sectionBegin, const size_type sectionEnd, const MemoryRange data) {
+  if (buffer_ <= data.ptr && data.ptr <= &buffer_[bufferSize_ - 1]) {
+    // Check whether there was actually memory allocated that is now being published.
+    const size_type requestedIndex = (data.ptr - buffer_);
+    size_type currentWriteIdx = Sync::loadOwn(sectionBegin);
+    if (requestedIndex != wrapToBufferIdx(currentWriteIdx)) {
+      // Reject out-of-order commit
+      this->countRejected(commitOperation(sectionBegin));
+      return 0;
+    }
+
+    const size_type numCommitableElems = contiguousBytes(currentWriteIdx, sectionEnd, true);
+    const size_type commitedLen{detail::min(data.len, numCommitableElems)};
+    const size_type newIdx = wrapToDoubleBufferIdx(currentWriteIdx + commitedLen);
+
+    if (Sync::kMultiProducer) {
+      // Multiple producers publish through publishOutOfOrder(), so this is a consume. Consumed bytes must no longer
+      // count as published when the producers reuse them.
+      clearCompletedSegments(currentWriteIdx, commitedLen);
+    }
+
+    // Check if the memory to be published was previously allocated.
+    if (Sync::update(sectionBegin, currentWriteIdx, newIdx)) {
+      recordSuccess(commitOperation(sectionBegin), data.ptr, commitedLen);
+      return commitedLen;
+    }
+    this->countCasFailure(commitOperation(sectionBegin));
+    return 0;
+  }
+  this->countRejected(commitOperation(sectionBegin));
+  return 0;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::commit(
+    atomic_size_type &sectionBegin, const size_type sectionEnd, const MemoryRangePair data) {
+  if (buffer_ <= data.first.ptr && data.first.ptr <= &buffer_[bufferSize_ - 1]) {
+    const size_type requestedIndex = (data.first.ptr - buffer_);
+    size_type currentIdx = Sync::loadOwn(sectionBegin);
+    if (requestedIndex != wrapToBufferIdx(currentIdx)) {
+      // Reject out-of-order commit
+      this->countRejected(commitOperation(sectionBegin));
+      return 0;
+    }
+
+    const size_type commitedLen{detail::min(contiguousLen(data), distance(currentIdx, sectionEnd))};
+    const size_type newIdx = wrapToDoubleBufferIdx(currentIdx + commitedLen);
+
+    if (Sync::kMultiProducer) {
+      clearCompletedSegments(currentIdx, commitedLen);
+    }
+
+    if (Sync::update(sectionBegin, currentIdx, newIdx)) {
+      recordSuccess(commitOperation(sectionBegin), data.first.ptr, commitedLen);
+      return commitedLen;
+    }
+    this->countCasFailure(commitOperation(sectionBegin));
+    return 0;
+  }
+  this->countRejected(commitOperation(sectionBegin));
+  return 0;
+}
+
+template <typename Traits>
+bool BasicAtomicRingBuffer<Traits>::shrink(const MemoryRange allocation, const size_type len) {
+  if (len >= allocation.len) {
+    return len == allocation.len;
+  }
+  if (!(buffer_ <= allocation.ptr && allocation.ptr <= &buffer_[bufferSize_ - 1])) {
+    return false;
+  }
+
+  const size_type origAllocateIdx = Sync::loadOwn(allocateIdx_);
+  const size_type allocationEnd = static_cast<size_type>(allocation.ptr - buffer_) + allocation.len;
+  if (wrapToBufferIdx(allocationEnd) != wrapToBufferIdx(origAllocateIdx)) {
+    // Only the most recent allocation ends at allocateIdx_.
+    return false;
+  }
+
+  const size_type newAllocateIdx = wrapToDoubleBufferIdx(origAllocateIdx + 2 * bufferSize_ - (allocation.len - len));
+  return Sync::unreserve(allocateIdx_, origAllocateIdx, newAllocateIdx);
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::publishOutOfOrder(
+    const MemoryRange data) {
+  const size_type commitedLen = markPublished(data);
+  if (commitedLen > 0) {
+    advanceWriteIdx();
+    recordSuccess(Operation::kPublish, data.ptr, commitedLen);
+  } else {
+    this->countRejected(Operation::kPublish);
+  }
+  return commitedLen;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::publishOutOfOrder(
+    const MemoryRangePair data) {
+  size_type commitedLen = markPublished(data.first);
+  if (commitedLen > 0 && contiguousLen(data) > data.first.len) {
+    commitedLen += markPublished(data.second);
+  }
+  if (commitedLen > 0) {
+    advanceWriteIdx();
+    recordSuccess(Operation::kPublish, data.first.ptr, commitedLen);
+  } else {
+    this->countRejected(Operation::kPublish);
+  }
+  return commitedLen;
+}
+
+template <typename Traits>
+typename BasicAtomicRingBuffer<Traits>::size_type BasicAtomicRingBuffer<Traits>::markPublished(
+    const MemoryRange data) {
+  if (buffer_ <= data.ptr && data.ptr <= &buffer_[bufferSize_ - 1]) {
+    const size_type requestedIndex = (data.ptr - buffer_);
+    const size_type currentWriteIdx = writeIdx_.load();
+    const size_type currentAllocateIdx = allocateIdx_.load();
+
+    // Check whether the memory to be published lies between writeIdx_ and allocateIdx_.
+    const size_type writeIndex = wrapToBufferIdx(currentWriteIdx);
+    const size_type offset =
+        (requestedIndex >= writeIndex) ? requestedIndex - writeIndex : requestedIndex + bufferSize_ - writeIndex;
+    const size_type numAllocatedElems = distance(currentWriteIdx, currentAllocateIdx);
+    if (offset >= numAllocatedElems) {
+      return 0;
+    }
+
+    const size_type numCommitableElems =
+        Traits::kMirroredBuffer ? numAllocatedElems - offset
+                                : detail::min(numAllocatedElems - offset, endIdx() - requestedIndex);
+    const size_type commitedLen{detail::min(data.len, numCommitableElems)};
+
+    markCompletedSegments(requestedIndex, commitedLen);
+    return commitedLen;
+  }
+  return 0;
+}
+
+template <typename Traits>
+void BasicAtomicRingBuffer<Traits>::advanceWriteIdx() {
+  size_type currentWriteIdx = writeIdx_.load();
+  while (true) {
+    const size_type currentAllocateIdx = allocateIdx_.load();
+    const size_type numCompletedElems = this->countCompleted(
+        wrapToBufferIdx(currentWriteIdx), distance(currentWriteIdx, currentAllocateIdx), bufferSize_);
+    if (numCompletedElems == 0) {
+      // Either nothing to do or another producer has not finished yet and will advance the index later.
+      return;
+    }
+
+    const size_type newIdx = wrapToDoubleBufferIdx(currentWriteIdx + numCompletedElems);
+    if (writeIdx_.compare_exchange_weak(currentWriteIdx, newIdx)) {
+      return;
+    }
+    this->countCasFailure(Operation::kPublish);
+    // Another producer moved the index. Continue from where it left off.
+  }
+}
+
+/**
+ * \brief The default AtomicRingBuffer with a compact memory layout.
+ */
+using AtomicRingBuffer = BasicAtomicRingBuffer<DefaultTraits>;
+
+/**
+ * \brief An AtomicRingBuffer that keeps producer and consumer state on separate cache lines.
+ */
+using CacheAlignedAtomicRingBuffer = BasicAtomicRingBuffer<CacheAlignedTraits>;
+
+/**
+ * \brief An AtomicRingBuffer for exactly one producer and one consumer thread that avoids loading the other side's
+ * index.
+ */
+using CachedIndexAtomicRingBuffer = BasicAtomicRingBuffer<CachedIndexTraits>;
+
+/**
+ * \brief An AtomicRingBuffer for exactly one producer and one consumer thread that does not use compare-and-swap.
+ */
+using SpscAtomicRingBuffer = BasicAtomicRingBuffer<SpscTraits>;
+
+/**
+ * \brief An AtomicRingBuffer for multiple producer threads and one consumer thread. See MultiProducerSynchronization.
+ */
+using MultiProducerAtomicRingBuffer = BasicAtomicRingBuffer<MultiProducerTraits>;
+
+/**
+ * \brief An AtomicRingBuffer whose allocations and peeks never stop at the end of the buffer. See MirroredMemory.
+ */
+using MirroredAtomicRingBuffer = BasicAtomicRingBuffer<MirroredTraits>;
+
+extern template class BasicAtomicRingBuffer<DefaultTraits>;
+extern template class BasicAtomicRingBuffer<CacheAlignedTraits>;
+extern template class BasicAtomicRingBuffer<CachedIndexTraits>;
+extern template class BasicAtomicRingBuffer<SpscTraits>;
+extern template class BasicAtomicRingBuffer<MultiProducerTraits>;
+extern template class BasicAtomicRingBuffer<MirroredTraits>;
+
 }  // namespace AtomicRingBuffer
 
 #endif  // !__ATOMIC_RING_BUFFER__H__
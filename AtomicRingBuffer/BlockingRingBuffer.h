@@ -0,0 +1,266 @@
+#ifndef __ATOMICRINGBUFFER__BLOCKINGRINGBUFFER_H__
+#define __ATOMICRINGBUFFER__BLOCKINGRINGBUFFER_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include "Lease.h"
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Adds blocking allocateWait() and peekWait() to a ring buffer.
+ *
+ * RingBuffer can be any buffer of this library that offers allocate(numElems, partial_acceptable) and
+ * peek(numElems, partial_acceptable), e.g. AtomicRingBuffer, StaticAtomicRingBuffer or ObjectRingBuffer.
+ *
+ * Every operation that publishes or consumes wakes up a waiting consumer or producer: publish(), consume(), shrink(),
+ * the leases returned by allocateLease() and peekLease(), and, if RingBuffer offers them, emplace(), push() and pop().
+ * All other operations are inherited unchanged and do not change the fill level. Calling the functions of RingBuffer
+ * directly, e.g. through a reference to the base class, bypasses the wake-up.
+ *
+ * A waiting call first retries the operation kSpinIterations times. Only then it registers itself as sleeping and
+ * parks on a condition variable. publish() and consume() only touch the mutex if the other side has registered itself,
+ * so the lock-free fast path stays lock-free while both sides are busy.
+ *
+ * Waiters and notifiers are ordered by sequentially consistent fences: A waiter registers before it checks the buffer
+ * a final time, a notifier updates the buffer before it checks for waiters. Thus, at least one of them sees the other.
+ *
+ * Without partial_acceptable, the waiting calls need numElems contiguous elements, which the other side cannot provide
+ * once the range would cross the end of the buffer: only the waiting side itself moves its index past the end. So
+ * allocateWait() gives up and returns an empty range when the buffer is empty, and peekWait() when at least numElems
+ * elements are available, but the operation still fails. Buffers with mirrored memory never give up.
+ */
+template <typename RingBuffer, uint32_t kSpinIterations = 64>
+class BlockingRingBuffer : public RingBuffer {
+ public:
+  using typename RingBuffer::size_type;
+  using typename RingBuffer::MemoryRange;
+
+  using RingBuffer::RingBuffer;
+
+  /**
+   * \brief Like allocate(), but waits until the allocation succeeds.
+   *
+   * \return An empty range if numElems contiguous elements cannot become free, see the class description.
+   */
+  MemoryRange allocateWait(const size_type numElems, const bool partial_acceptable) {
+    return allocateWaitUntil(numElems, partial_acceptable, std::chrono::steady_clock::time_point::max());
+  }
+
+  /**
+   * \brief Like allocate(), but waits until the allocation succeeds or the timeout expires.
+   *
+   * \return An empty range if the timeout expired or numElems contiguous elements cannot become free.
+   */
+  template <typename Rep, typename Period>
+  MemoryRange allocateWait(const size_type numElems, const bool partial_acceptable,
+                           const std::chrono::duration<Rep, Period> &timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return allocateWaitUntil(numElems, partial_acceptable,
+                             std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline));
+  }
+
+  /**
+   * \brief Like peek(), but waits until data is available.
+   *
+   * \return An empty range if numElems contiguous elements cannot become available, see the class description.
+   */
+  MemoryRange peekWait(const size_type numElems, const bool partial_acceptable) {
+    return peekWaitUntil(numElems, partial_acceptable, std::chrono::steady_clock::time_point::max());
+  }
+
+  /**
+   * \brief Like peek(), but waits until data is available or the timeout expires.
+   *
+   * \return An empty range if the timeout expired or numElems contiguous elements cannot become available.
+   */
+  template <typename Rep, typename Period>
+  MemoryRange peekWait(const size_type numElems, const bool partial_acceptable,
+                       const std::chrono::duration<Rep, Period> &timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return peekWaitUntil(numElems, partial_acceptable,
+                         std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline));
+  }
+
+  /**
+   * \brief Publish data and wake up a sleeping consumer.
+   */
+  template <typename Range>
+  size_type publish(const Range &data) {
+    const size_type numPublished = RingBuffer::publish(data);
+    if (numPublished > 0) {
+      notify(consumerSide_);
+    }
+    return numPublished;
+  }
+
+  /**
+   * \brief Consume data and wake up a sleeping producer.
+   */
+  template <typename Range>
+  size_type consume(const Range &data) {
+    const size_type numConsumed = RingBuffer::consume(data);
+    if (numConsumed > 0) {
+      notify(producerSide_);
+    }
+    return numConsumed;
+  }
+
+  /**
+   * \brief Return the end of the most recent allocation and wake up a sleeping producer.
+   */
+  template <typename Range>
+  bool shrink(const Range &allocation, const size_type len) {
+    const bool shrunk = RingBuffer::shrink(allocation, len);
+    if (shrunk && len < allocation.len) {
+      notify(producerSide_);
+    }
+    return shrunk;
+  }
+
+  /**
+   * \brief Like allocate(), but the elements are published through publish() of this class when the returned lease goes
+   * out of scope.
+   */
+  WriteLease<BlockingRingBuffer> allocateLease(const size_type numElems, const bool partial_acceptable) {
+    return WriteLease<BlockingRingBuffer>(*this, RingBuffer::allocate(numElems, partial_acceptable));
+  }
+
+  /**
+   * \brief Like peek(), but the elements are consumed through consume() of this class when the returned lease goes out
+   * of scope.
+   */
+  ReadLease<BlockingRingBuffer> peekLease(const size_type numElems, const bool partial_acceptable) {
+    return ReadLease<BlockingRingBuffer>(*this, RingBuffer::peek(numElems, partial_acceptable));
+  }
+
+  /**
+   * \brief RingBuffer::emplace(), which also wakes up a sleeping consumer.
+   *
+   * Like push() and pop(), only available if RingBuffer has such a member. Base delays the lookup until the call.
+   */
+  template <typename... Args, typename Base = RingBuffer>
+  auto emplace(Args &&... args) -> decltype(std::declval<Base &>().emplace(std::forward<Args>(args)...)) {
+    const auto result = RingBuffer::emplace(std::forward<Args>(args)...);
+    if (result) {
+      notify(consumerSide_);
+    }
+    return result;
+  }
+
+  /**
+   * \brief RingBuffer::push(), which also wakes up a sleeping consumer.
+   */
+  template <typename... Args, typename Base = RingBuffer>
+  auto push(Args &&... args) -> decltype(std::declval<Base &>().push(std::forward<Args>(args)...)) {
+    const auto result = RingBuffer::push(std::forward<Args>(args)...);
+    if (result) {
+      notify(consumerSide_);
+    }
+    return result;
+  }
+
+  /**
+   * \brief RingBuffer::pop(), which also wakes up a sleeping producer.
+   */
+  template <typename... Args, typename Base = RingBuffer>
+  auto pop(Args &&... args) -> decltype(std::declval<Base &>().pop(std::forward<Args>(args)...)) {
+    const auto result = RingBuffer::pop(std::forward<Args>(args)...);
+    if (result) {
+      notify(producerSide_);
+    }
+    return result;
+  }
+
+ private:
+  /**
+   * \brief State of the threads of one side that are sleeping.
+   */
+  struct WaitState {
+    std::atomic<uint32_t> numSleeping{0};
+    std::mutex mutex;
+    std::condition_variable condition;
+  };
+
+  MemoryRange allocateWaitUntil(const size_type numElems, const bool partial_acceptable,
+                                const std::chrono::steady_clock::time_point deadline) {
+    const auto allocate = [this, numElems, partial_acceptable]() {
+      return RingBuffer::allocate(numElems, partial_acceptable);
+    };
+    // Consumers cannot move the allocation index, so an empty buffer that has no room will never have it.
+    const auto hopeless = [this]() { return RingBuffer::empty(); };
+    return waitUntil(producerSide_, allocate, hopeless, deadline);
+  }
+
+  MemoryRange peekWaitUntil(const size_type numElems, const bool partial_acceptable,
+                            const std::chrono::steady_clock::time_point deadline) {
+    const auto peek = [this, numElems, partial_acceptable]() { return RingBuffer::peek(numElems, partial_acceptable); };
+    // Producers cannot move the read index, so data that is available but not contiguous will stay that way.
+    const auto hopeless = [this, numElems]() { return RingBuffer::size() >= numElems; };
+    return waitUntil(consumerSide_, peek, hopeless, deadline);
+  }
+
+  /**
+   * \brief Retry operation until it returns a range or the deadline expires. Gives up as soon as hopeless() says that
+   * waiting for the other side cannot make the operation succeed.
+   */
+  template <typename Operation, typename Hopeless>
+  MemoryRange waitUntil(WaitState &state, Operation operation, Hopeless hopeless,
+                        const std::chrono::steady_clock::time_point deadline) {
+    for (uint32_t i = 0; i <= kSpinIterations; ++i) {
+      const MemoryRange range = operation();
+      if (range.len != 0) {
+        return range;
+      }
+      if (hopeless()) {
+        return operation();
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.numSleeping.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    MemoryRange range = operation();
+    while (range.len == 0) {
+      if (hopeless()) {
+        range = operation();
+        break;
+      }
+      if (deadline == std::chrono::steady_clock::time_point::max()) {
+        state.condition.wait(lock);
+      } else if (state.condition.wait_until(lock, deadline) == std::cv_status::timeout) {
+        range = operation();
+        break;
+      }
+      range = operation();
+    }
+
+    state.numSleeping.fetch_sub(1, std::memory_order_relaxed);
+    return range;
+  }
+
+  void notify(WaitState &state) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state.numSleeping.load(std::memory_order_relaxed) != 0) {
+      // Taking the mutex ensures that the sleeper either has not checked the buffer yet or is already waiting.
+      { std::lock_guard<std::mutex> lock(state.mutex); }
+      state.condition.notify_all();
+    }
+  }
+
+  // Producers waiting for free space.
+  WaitState producerSide_;
+
+  // Consumers waiting for data.
+  WaitState consumerSide_;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__BLOCKINGRINGBUFFER_H__
@@ -0,0 +1,125 @@
+#ifndef __ATOMICRINGBUFFER__COMPLETIONMAP_H__
+#define __ATOMICRINGBUFFER__COMPLETIONMAP_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AtomicRingBuffer {
+namespace detail {
+
+/**
+ * \brief Records which bytes of a buffer have been published, one bit per byte.
+ *
+ * Used by multiple producers to publish out of order. The disabled variant is empty and does nothing.
+ */
+template <bool kEnabled>
+class CompletionMap {
+ public:
+  using word_type = std::atomic<std::uint32_t>;
+
+  void initCompletionMap(word_type *, std::size_t) {}
+  void markCompleted(std::size_t, std::size_t) {}
+  void clearCompleted(std::size_t, std::size_t) {}
+  std::size_t countCompleted(std::size_t, std::size_t, std::size_t) const { return 0; }
+};
+
+template <>
+class CompletionMap<true> {
+ public:
+  using word_type = std::atomic<std::uint32_t>;
+
+  constexpr static std::size_t kBitsPerWord = 32;
+
+  constexpr static std::size_t numWords(const std::size_t numBytes) {
+    return (numBytes + kBitsPerWord - 1) / kBitsPerWord;
+  }
+
+  void initCompletionMap(word_type *words, const std::size_t numWords) {
+    words_ = words;
+    for (std::size_t i = 0; i < numWords; ++i) {
+      words_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * \brief Mark len bytes starting at position as published. The range must not wrap around.
+   *
+   * Marking and scanning use sequential consistency. Otherwise, two producers completing adjacent ranges could both
+   * miss the other's mark and neither would advance the write index past both ranges.
+   */
+  void markCompleted(const std::size_t position, const std::size_t len) {
+    forEachWord(position, len, [](word_type &word, const std::uint32_t mask) { word.fetch_or(mask); });
+  }
+
+  /**
+   * \brief Mark len bytes starting at position as free again. The range must not wrap around.
+   */
+  void clearCompleted(const std::size_t position, const std::size_t len) {
+    forEachWord(position, len, [](word_type &word, const std::uint32_t mask) {
+      word.fetch_and(~mask, std::memory_order_release);
+    });
+  }
+
+  /**
+   * \brief Count the bytes marked as published starting at position, wrapping around at bufferSize.
+   *
+   * \param maxLen Stop counting after this many bytes.
+   */
+  std::size_t countCompleted(const std::size_t position, const std::size_t maxLen, const std::size_t bufferSize) const {
+    std::size_t count = 0;
+    while (count < maxLen) {
+      std::size_t bitIdx = position + count;
+      if (bitIdx >= bufferSize) {
+        bitIdx -= bufferSize;
+      }
+      const std::size_t bitOffset = bitIdx % kBitsPerWord;
+      std::size_t bitsToCheck = kBitsPerWord - bitOffset;
+      bitsToCheck = (bitsToCheck > bufferSize - bitIdx) ? bufferSize - bitIdx : bitsToCheck;
+      bitsToCheck = (bitsToCheck > maxLen - count) ? maxLen - count : bitsToCheck;
+
+      const std::uint32_t word = words_[bitIdx / kBitsPerWord].load() >> bitOffset;
+      const std::size_t completed = countTrailingOnes(word, bitsToCheck);
+      count += completed;
+      if (completed < bitsToCheck) {
+        break;
+      }
+    }
+    return count;
+  }
+
+ private:
+  template <typename Op>
+  void forEachWord(std::size_t position, std::size_t len, Op op) {
+    while (len > 0) {
+      const std::size_t bitOffset = position % kBitsPerWord;
+      const std::size_t numBits = (len > kBitsPerWord - bitOffset) ? kBitsPerWord - bitOffset : len;
+      const std::uint32_t mask =
+          (numBits == kBitsPerWord) ? ~std::uint32_t{0} : (((std::uint32_t{1} << numBits) - 1) << bitOffset);
+      op(words_[position / kBitsPerWord], mask);
+      position += numBits;
+      len -= numBits;
+    }
+  }
+
+  static std::size_t countTrailingOnes(std::uint32_t word, const std::size_t limit) {
+    const std::uint32_t mask = (limit >= kBitsPerWord) ? ~std::uint32_t{0} : ((std::uint32_t{1} << limit) - 1);
+    if ((word & mask) == mask) {
+      return limit;
+    }
+
+    std::size_t count = 0;
+    while (count < limit && (word & 1u) != 0) {
+      word >>= 1;
+      ++count;
+    }
+    return count;
+  }
+
+  word_type *words_ = nullptr;
+};
+
+}  // namespace detail
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__COMPLETIONMAP_H__
@@ -0,0 +1,74 @@
+#ifndef __ATOMICRINGBUFFER__FDWRITER_H__
+#define __ATOMICRINGBUFFER__FDWRITER_H__
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <cstddef>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Write up to maxLen bytes of published data from buffer to fd with a single writev() call, and consume exactly
+ * the bytes that were written.
+ *
+ * Data that wraps around the end of the buffer is passed to the kernel as two iovecs, so each call costs one system
+ * call and copies nothing in user space. The call is retried if it is interrupted by a signal. A consumer that forwards
+ * everything to a file or socket calls it until the buffer is empty:
+ *
+ *     while (!ringBuffer.empty() && writeToFd(fd, ringBuffer) > 0) {
+ *     }
+ *
+ * Must only be called by the consumer of buffer. Only available on UNIX.
+ *
+ * \return The number of bytes written and consumed, 0 if the buffer is empty, or -1 if writev() failed, with errno set
+ * accordingly. On a non-blocking fd that is not ready, this is -1 with errno set to EAGAIN or EWOULDBLOCK.
+ */
+template <typename Buffer>
+ssize_t writeToFd(const int fd, Buffer &buffer, const typename Buffer::size_type maxLen) {
+  using MemoryRange = typename Buffer::MemoryRange;
+  using MemoryRangePair = typename Buffer::MemoryRangePair;
+  using size_type = typename Buffer::size_type;
+
+  const MemoryRangePair segments = buffer.peekSegments(maxLen, true);
+  if (segments.len() == 0) {
+    return 0;
+  }
+
+  iovec iov[2];
+  iov[0].iov_base = segments.first.ptr;
+  iov[0].iov_len = segments.first.len;
+  iov[1].iov_base = segments.second.ptr;
+  iov[1].iov_len = segments.second.len;
+  const int iovcnt = (segments.second.len == 0) ? 1 : 2;
+
+  ssize_t written;
+  do {
+    written = ::writev(fd, iov, iovcnt);
+  } while (written < 0 && errno == EINTR);
+  if (written <= 0) {
+    return written;
+  }
+
+  // Consume the accepted prefix only, so that the rest is written by the next call.
+  const size_type numWritten = static_cast<size_type>(written);
+  if (numWritten <= segments.first.len) {
+    buffer.consume(MemoryRange{segments.first.ptr, numWritten});
+  } else {
+    buffer.consume(MemoryRangePair{segments.first, MemoryRange{segments.second.ptr, numWritten - segments.first.len}});
+  }
+  return written;
+}
+
+/**
+ * \brief Write as much published data as a single writev() call accepts. See writeToFd(int, Buffer &, size_type).
+ */
+template <typename Buffer>
+ssize_t writeToFd(const int fd, Buffer &buffer) {
+  return writeToFd(fd, buffer, buffer.capacity());
+}
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__FDWRITER_H__
@@ -0,0 +1,74 @@
+#include "AtomicRingBuffer/HugePageMemory.h"
+
+#ifdef __linux__
+
+#include <sys/mman.h>
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+// Request 2 MiB pages explicitly, as the default huge page size of the system may differ.
+#ifdef MAP_HUGE_SHIFT
+constexpr int kHugePageFlags = MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+#else
+constexpr int kHugePageFlags = MAP_HUGETLB;
+#endif
+
+}  // namespace
+
+bool HugePageMemory::map(const size_type minSize) {
+  unmap();
+  if (minSize == 0) {
+    return false;
+  }
+
+  const size_type page = hugePageSize();
+  const size_type size = ((minSize + page - 1) / page) * page;
+
+  void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | kHugePageFlags, -1, 0);
+  explicitHugePages_ = (region != MAP_FAILED);
+  if (!explicitHugePages_) {
+    region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+      return false;
+    }
+#ifdef MADV_HUGEPAGE
+    // Only a hint. Fails if transparent huge pages are disabled, which leaves regular pages.
+    madvise(region, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  data_ = static_cast<pointer_type>(region);
+  size_ = size;
+  return true;
+}
+
+void HugePageMemory::unmap() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+    explicitHugePages_ = false;
+  }
+}
+
+// The huge page size of x86-64 and of AArch64 with 4 KiB base pages, also used by transparent huge pages.
+HugePageMemory::size_type HugePageMemory::hugePageSize() { return size_type{2} * 1024 * 1024; }
+
+}  // namespace AtomicRingBuffer
+
+#else
+
+namespace AtomicRingBuffer {
+
+// Huge page mappings are not supported on this platform.
+bool HugePageMemory::map(const size_type) { return false; }
+
+void HugePageMemory::unmap() {}
+
+HugePageMemory::size_type HugePageMemory::hugePageSize() { return 1; }
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __linux__
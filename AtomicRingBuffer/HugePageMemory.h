@@ -0,0 +1,83 @@
+#ifndef __ATOMICRINGBUFFER__HUGEPAGEMEMORY_H__
+#define __ATOMICRINGBUFFER__HUGEPAGEMEMORY_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Anonymous memory backed by huge pages where available, to reduce TLB misses on large buffers.
+ *
+ * Intended as storage for large ring buffers, e.g. via BasicObjectRingBuffer::init() or AtomicRingBuffer::init().
+ *
+ * The size is rounded up to a multiple of hugePageSize(). On Linux, map() first requests pages from the hugetlbfs pool
+ * using MAP_HUGETLB. If the pool is empty, it falls back to a regular mapping that is advised to use transparent huge
+ * pages. On other platforms, map() always fails.
+ */
+class HugePageMemory {
+ public:
+  using value_type = uint8_t;
+  using pointer_type = value_type*;
+  using size_type = std::size_t;
+
+  HugePageMemory() = default;
+  ~HugePageMemory() { unmap(); }
+
+  HugePageMemory(const HugePageMemory&) = delete;
+  HugePageMemory& operator=(const HugePageMemory&) = delete;
+
+  HugePageMemory(HugePageMemory&& other) noexcept
+      : data_(other.data_), size_(other.size_), explicitHugePages_(other.explicitHugePages_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  HugePageMemory& operator=(HugePageMemory&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = other.data_;
+      size_ = other.size_;
+      explicitHugePages_ = other.explicitHugePages_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * \brief Map at least minSize bytes. Releases a previous mapping.
+   *
+   * \return Whether the mapping was created. On failure, data() is nullptr and size() is 0.
+   */
+  bool map(const size_type minSize);
+
+  /**
+   * \brief Release the mapping. Does nothing if there is none.
+   */
+  void unmap();
+
+  pointer_type data() const { return data_; }
+
+  size_type size() const { return size_; }
+
+  /**
+   * \brief Whether the memory was taken from the hugetlbfs pool. Otherwise, the kernel may still back it with
+   * transparent huge pages.
+   */
+  bool explicitHugePages() const { return explicitHugePages_; }
+
+  /**
+   * \brief Granularity to which map() rounds up the requested size.
+   */
+  static size_type hugePageSize();
+
+ private:
+  pointer_type data_ = nullptr;
+  size_type size_ = 0;
+  bool explicitHugePages_ = false;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__HUGEPAGEMEMORY_H__
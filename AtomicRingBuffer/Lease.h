@@ -0,0 +1,214 @@
+#ifndef __ATOMICRINGBUFFER__LEASE_H__
+#define __ATOMICRINGBUFFER__LEASE_H__
+
+#include <cassert>
+#include <cstddef>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Move-only handle to allocated memory that is published when the handle goes out of scope.
+ *
+ * Obtained from allocateLease() of AtomicRingBuffer or ObjectRingBuffer. The memory can be written in place, e.g. by
+ * constructing objects with placement new. commit() publishes early or publishes only the first elements and returns
+ * the rest of the allocation to the buffer.
+ *
+ * The buffer only accepts publishes in allocation order, so leases must be released in the order they were allocated.
+ * A lease that is destroyed out of order would lose its allocation and block all later publishes, which is caught by
+ * an assertion. When leases are nested in one scope, commit() the outer one before the inner one goes out of scope.
+ *
+ * The handle consists of a pointer to the buffer and the allocated range. All member functions are inline.
+ */
+template <typename Buffer>
+class WriteLease {
+ public:
+  using MemoryRange = typename Buffer::MemoryRange;
+  using size_type = typename Buffer::size_type;
+  using value_type = typename Buffer::value_type;
+  using pointer_type = value_type *;
+
+  WriteLease() = default;
+  WriteLease(Buffer &buffer, const MemoryRange range) : buffer_(&buffer), range_(range) {}
+
+  WriteLease(const WriteLease &) = delete;
+  WriteLease &operator=(const WriteLease &) = delete;
+
+  WriteLease(WriteLease &&other) noexcept : buffer_(other.buffer_), range_(other.range_) {
+    other.range_ = MemoryRange{};
+  }
+
+  WriteLease &operator=(WriteLease &&other) noexcept {
+    if (this != &other) {
+      release();
+      buffer_ = other.buffer_;
+      range_ = other.range_;
+      other.range_ = MemoryRange{};
+    }
+    return *this;
+  }
+
+  ~WriteLease() { release(); }
+
+  /**
+   * \brief Whether the lease holds memory, i.e. whether the allocation succeeded.
+   */
+  explicit operator bool() const { return range_.len != 0; }
+
+  pointer_type data() const { return range_.ptr; }
+  size_type size() const { return range_.len; }
+  pointer_type begin() const { return range_.ptr; }
+  pointer_type end() const { return range_.ptr + range_.len; }
+  value_type &operator[](const size_type idx) const { return range_.ptr[idx]; }
+
+  const MemoryRange &range() const { return range_; }
+
+  /**
+   * \brief Publish all elements. The lease is empty afterwards, unless the buffer rejected the publish.
+   *
+   * \return The number of elements published, or 0 if an earlier allocation has not been published yet. The lease
+   * then keeps its elements, so that commit() can be called again after the earlier allocation.
+   */
+  size_type commit() { return commit(range_.len); }
+
+  /**
+   * \brief Publish the first len elements and return the rest to the buffer. The lease is empty afterwards, unless
+   * the buffer rejected the publish.
+   *
+   * Only the most recent allocation can be returned. Committing a shorter length after another allocation has been
+   * made is an error, since the unwritten rest could neither be returned nor be published. It is caught by an
+   * assertion, and without assertions, nothing is published and the lease keeps all elements.
+   *
+   * \return The number of elements published, or 0 if nothing could be published.
+   */
+  size_type commit(const size_type len) {
+    if (range_.len == 0) {
+      return 0;
+    }
+    if (len < range_.len) {
+      const bool returned = buffer_->shrink(range_, len);
+      assert(returned && "Only the most recent allocation can be committed shorter.");
+      if (!returned) {
+        return 0;
+      }
+      range_.len = len;
+    }
+    const size_type published = (range_.len != 0) ? buffer_->publish(range_) : 0;
+    if (published == range_.len) {
+      range_ = MemoryRange{};
+    }
+    return published;
+  }
+
+ private:
+  /**
+   * \brief Publish all elements when the lease is given up. Nothing can be reported from here, so a rejected publish
+   * is caught by an assertion.
+   */
+  void release() {
+    const size_type len = range_.len;
+    const size_type published = commit();
+    assert(published == len && "Write leases must be released in allocation order.");
+    (void)len;
+    (void)published;
+  }
+
+  Buffer *buffer_ = nullptr;
+  MemoryRange range_;
+};
+
+/**
+ * \brief Move-only handle to peeked data that is consumed when the handle goes out of scope.
+ *
+ * Obtained from peekLease() of AtomicRingBuffer or ObjectRingBuffer. commit() consumes early or consumes only the first
+ * elements, leaving the rest to be peeked again.
+ *
+ * The buffer only accepts consumes in order, so leases on the same data must not overlap, and a lease that is destroyed
+ * while an earlier one is still held is caught by an assertion.
+ */
+template <typename Buffer>
+class ReadLease {
+ public:
+  using MemoryRange = typename Buffer::MemoryRange;
+  using size_type = typename Buffer::size_type;
+  using value_type = typename Buffer::value_type;
+  using const_pointer_type = const value_type *;
+
+  ReadLease() = default;
+  ReadLease(Buffer &buffer, const MemoryRange range) : buffer_(&buffer), range_(range) {}
+
+  ReadLease(const ReadLease &) = delete;
+  ReadLease &operator=(const ReadLease &) = delete;
+
+  ReadLease(ReadLease &&other) noexcept : buffer_(other.buffer_), range_(other.range_) {
+    other.range_ = MemoryRange{};
+  }
+
+  ReadLease &operator=(ReadLease &&other) noexcept {
+    if (this != &other) {
+      release();
+      buffer_ = other.buffer_;
+      range_ = other.range_;
+      other.range_ = MemoryRange{};
+    }
+    return *this;
+  }
+
+  ~ReadLease() { release(); }
+
+  /**
+   * \brief Whether the lease holds data, i.e. whether the peek succeeded.
+   */
+  explicit operator bool() const { return range_.len != 0; }
+
+  const_pointer_type data() const { return range_.ptr; }
+  size_type size() const { return range_.len; }
+  const_pointer_type begin() const { return range_.ptr; }
+  const_pointer_type end() const { return range_.ptr + range_.len; }
+  const value_type &operator[](const size_type idx) const { return range_.ptr[idx]; }
+
+  const MemoryRange &range() const { return range_; }
+
+  /**
+   * \brief Consume all elements. The lease is empty afterwards, unless the buffer rejected the consume.
+   *
+   * \return The number of elements consumed, or 0 if the data is not at the front of the buffer. The lease then keeps
+   * its elements.
+   */
+  size_type commit() { return commit(range_.len); }
+
+  /**
+   * \brief Consume the first len elements. The others remain available to the next peek. The lease is empty afterwards,
+   * unless the buffer rejected the consume.
+   */
+  size_type commit(const size_type len) {
+    if (range_.len == 0) {
+      return 0;
+    }
+    MemoryRange consumed = range_;
+    consumed.len = (len < range_.len) ? len : range_.len;
+    const size_type numConsumed = (consumed.len != 0) ? buffer_->consume(consumed) : 0;
+    if (numConsumed == consumed.len) {
+      range_ = MemoryRange{};
+    }
+    return numConsumed;
+  }
+
+ private:
+  /**
+   * \brief Consume all elements when the lease is given up. A rejected consume is caught by an assertion.
+   */
+  void release() {
+    const size_type len = range_.len;
+    const size_type consumed = commit();
+    assert(consumed == len && "Read leases must be released in order.");
+    (void)len;
+    (void)consumed;
+  }
+
+  Buffer *buffer_ = nullptr;
+  MemoryRange range_;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__LEASE_H__
@@ -0,0 +1,214 @@
+#ifndef __ATOMICRINGBUFFER__MESSAGERINGBUFFER_H__
+#define __ATOMICRINGBUFFER__MESSAGERINGBUFFER_H__
+
+#include <cstdint>
+#include <cstring>
+
+#include "AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Passes messages of variable length through a BasicAtomicRingBuffer.
+ *
+ * Each message is stored as a record: A 4 byte header holding the payload length, followed by the payload and padded to
+ * a multiple of 4 bytes. A record never wraps around the end of the buffer. If it does not fit in front of the end,
+ * the producer fills the rest of the buffer with a skip marker, which the consumer steps over, and places the record at
+ * the beginning. With MirroredTraits, records simply continue in the mirror and no space is skipped.
+ *
+ * Every record is allocated, published, peeked and consumed as a whole, so each message costs a single index update on
+ * either side. If the storage is aligned to 4 bytes, so is every payload.
+ *
+ * Supports one producer thread and one consumer thread, as the producer keeps track of the end of its last record.
+ */
+template <typename Traits = DefaultTraits>
+class BasicMessageRingBuffer {
+ public:
+  using Buffer_t = BasicAtomicRingBuffer<Traits>;
+  using size_type = typename Buffer_t::size_type;
+  using pointer_type = typename Buffer_t::pointer_type;
+  using MemoryRange = typename Buffer_t::MemoryRange;
+  using header_type = uint32_t;
+
+  static_assert(!Traits::Synchronization::kMultiProducer, "MessageRingBuffer supports a single producer only.");
+
+  /**
+   * \brief The payload of a message that has been read.
+   */
+  struct MessageView {
+    const uint8_t *ptr = nullptr;
+    size_type len = 0;
+
+    bool operator==(const MessageView &other) const { return ptr == other.ptr && len == other.len; }
+  };
+
+  constexpr static size_type kHeaderSize = sizeof(header_type);
+  constexpr static size_type kAlignment = sizeof(header_type);
+
+  /**
+   * \brief Use len bytes of storage starting at buf. len is rounded down to a multiple of kAlignment.
+   */
+  void init(pointer_type buf, const size_type len) {
+    const size_type usableLen = len - len % kAlignment;
+    buffer_.init(buf, usableLen);
+    begin_ = buf;
+    end_ = buf + usableLen;
+    next_ = buf;
+  }
+
+  /**
+   * \brief Copy a message of len bytes into the buffer and publish it.
+   *
+   * \return Whether the message was written. Fails if there is not enough free space.
+   */
+  bool tryWrite(const void *data, const size_type len) {
+    const MemoryRange payload = reserve(len);
+    if (payload.ptr == nullptr) {
+      return false;
+    }
+    memcpy(payload.ptr, data, len);
+    return commit(payload);
+  }
+
+  /**
+   * \brief Reserve space for a message of len bytes, which can be written in place and must then be passed to commit().
+   *
+   * Several reservations may be outstanding. They must be committed in the order they were made. A reservation that
+   * has to skip the end of the buffer fails while an earlier reservation is outstanding, as the skipped bytes can only
+   * be published once all bytes before them are.
+   *
+   * \return The payload of the message, or a range with a nullptr if there is not enough free space.
+   */
+  MemoryRange reserve(const size_type len) {
+    if (len >= kSkipMarker || recordLen(len) > buffer_.capacity()) {
+      return MemoryRange{};
+    }
+    const size_type numRecordBytes = recordLen(len);
+
+    if (!Traits::kMirroredBuffer) {
+      const size_type tailLen = static_cast<size_type>(end_ - next_);
+      if (numRecordBytes > tailLen) {
+        // Skip the rest of the buffer, so that the record starts at the beginning.
+        const MemoryRange padding = buffer_.allocate(tailLen, false);
+        if (padding.len == 0) {
+          return MemoryRange{};
+        }
+        writeHeader(padding.ptr, kSkipMarker);
+        if (buffer_.publish(padding) != padding.len) {
+          // An earlier reservation has not been committed yet, so the padding cannot be published in order. Return it,
+          // as an unpublished allocation would block all later records.
+          buffer_.shrink(padding, 0);
+          return MemoryRange{};
+        }
+        next_ = begin_;
+      }
+    }
+
+    const MemoryRange record = buffer_.allocate(numRecordBytes, false);
+    if (record.len == 0) {
+      return MemoryRange{};
+    }
+    writeHeader(record.ptr, static_cast<header_type>(len));
+
+    next_ = record.ptr + numRecordBytes;
+    if (next_ >= end_) {
+      next_ -= (end_ - begin_);
+    }
+    return MemoryRange{record.ptr + kHeaderSize, len};
+  }
+
+  /**
+   * \brief Publish a message obtained from reserve().
+   */
+  bool commit(const MemoryRange payload) {
+    const MemoryRange record{payload.ptr - kHeaderSize, recordLen(payload.len)};
+    return buffer_.publish(record) == record.len;
+  }
+
+  /**
+   * \brief Obtain the next message without copying it. Repeated calls return the same message until it is consumed.
+   *
+   * \return The payload of the message, or a view with a nullptr if no message is available.
+   */
+  MessageView tryRead() {
+    while (true) {
+      const MemoryRange data = buffer_.peek(buffer_.capacity(), true);
+      if (data.len < kHeaderSize) {
+        return MessageView{};
+      }
+
+      const header_type header = readHeader(data.ptr);
+      if (header == kSkipMarker) {
+        // The skip marker covers everything up to the end of the buffer.
+        buffer_.consume(MemoryRange{data.ptr, static_cast<size_type>(end_ - data.ptr)});
+        continue;
+      }
+      if (data.len < recordLen(header)) {
+        return MessageView{};
+      }
+      return MessageView{data.ptr + kHeaderSize, header};
+    }
+  }
+
+  /**
+   * \brief Free the space of a message obtained from tryRead().
+   */
+  bool consume(const MessageView message) {
+    const MemoryRange record{const_cast<pointer_type>(message.ptr) - kHeaderSize, recordLen(message.len)};
+    return buffer_.consume(record) == record.len;
+  }
+
+  bool empty() const { return buffer_.empty(); }
+
+  size_type capacity() const { return buffer_.capacity(); }
+
+  /**
+   * \brief The longest message that fits into an empty buffer.
+   */
+  size_type maxMessageLen() const { return capacity() - kHeaderSize; }
+
+ private:
+  constexpr static header_type kSkipMarker = 0xFFFFFFFF;
+
+  constexpr static size_type recordLen(const size_type len) {
+    return (kHeaderSize + len + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  static void writeHeader(pointer_type ptr, const header_type header) { memcpy(ptr, &header, sizeof(header)); }
+
+  static header_type readHeader(const uint8_t *ptr) {
+    header_type header;
+    memcpy(&header, ptr, sizeof(header));
+    return header;
+  }
+
+  Buffer_t buffer_;
+  pointer_type begin_ = nullptr;
+  pointer_type end_ = nullptr;
+
+  // Where the producer allocates the next record.
+  pointer_type next_ = nullptr;
+};
+
+template <typename Traits>
+constexpr typename BasicMessageRingBuffer<Traits>::size_type BasicMessageRingBuffer<Traits>::kHeaderSize;
+
+template <typename Traits>
+constexpr typename BasicMessageRingBuffer<Traits>::size_type BasicMessageRingBuffer<Traits>::kAlignment;
+
+template <typename Traits>
+constexpr typename BasicMessageRingBuffer<Traits>::header_type BasicMessageRingBuffer<Traits>::kSkipMarker;
+
+/**
+ * \brief A MessageRingBuffer on top of the default AtomicRingBuffer.
+ */
+using MessageRingBuffer = BasicMessageRingBuffer<DefaultTraits>;
+
+/**
+ * \brief A MessageRingBuffer whose records never have to skip the end of the buffer. See MirroredMemory.
+ */
+using MirroredMessageRingBuffer = BasicMessageRingBuffer<MirroredTraits>;
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__MESSAGERINGBUFFER_H__
@@ -0,0 +1,69 @@
+#include "AtomicRingBuffer/MirroredMemory.h"
+
+#ifdef __linux__
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace AtomicRingBuffer {
+
+bool MirroredMemory::map(const size_type minSize) {
+  unmap();
+  if (minSize == 0) {
+    return false;
+  }
+
+  const size_type page = pageSize();
+  const size_type size = ((minSize + page - 1) / page) * page;
+
+  const int fd = memfd_create("AtomicRingBuffer", MFD_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    // Reserve an address range for both copies first, so that no other mapping can end up between them.
+    void* const region = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region != MAP_FAILED) {
+      pointer_type const base = static_cast<pointer_type>(region);
+      if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+          mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+        data_ = base;
+        size_ = size;
+      } else {
+        munmap(region, 2 * size);
+      }
+    }
+  }
+
+  // The mappings keep the memory alive.
+  close(fd);
+  return data_ != nullptr;
+}
+
+void MirroredMemory::unmap() {
+  if (data_ != nullptr) {
+    munmap(data_, 2 * size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+MirroredMemory::size_type MirroredMemory::pageSize() { return static_cast<size_type>(sysconf(_SC_PAGESIZE)); }
+
+}  // namespace AtomicRingBuffer
+
+#else
+
+namespace AtomicRingBuffer {
+
+// Mirrored mappings are not supported on this platform.
+bool MirroredMemory::map(const size_type) { return false; }
+
+void MirroredMemory::unmap() {}
+
+MirroredMemory::size_type MirroredMemory::pageSize() { return 1; }
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __linux__
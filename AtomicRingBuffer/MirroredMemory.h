@@ -0,0 +1,85 @@
+#ifndef __ATOMICRINGBUFFER__MIRROREDMEMORY_H__
+#define __ATOMICRINGBUFFER__MIRROREDMEMORY_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Memory that is mapped twice back-to-back, so that byte size() + i is the same byte as byte i.
+ *
+ * Intended as storage for a MirroredAtomicRingBuffer, which can then hand out ranges across the end of the buffer
+ * without splitting them:
+ *
+ *     MirroredMemory memory;
+ *     if (memory.map(kMinSize)) {
+ *       ringBuffer.init(memory.data(), memory.size());
+ *     }
+ *
+ * The size is rounded up to a multiple of the page size. Only available on Linux, where the mapping is created using
+ * memfd_create() and two fixed mmap() calls into a reserved address range. On other platforms, map() always fails.
+ */
+class MirroredMemory {
+ public:
+  using value_type = uint8_t;
+  using pointer_type = value_type*;
+  using size_type = std::size_t;
+
+  MirroredMemory() = default;
+  ~MirroredMemory() { unmap(); }
+
+  MirroredMemory(const MirroredMemory&) = delete;
+  MirroredMemory& operator=(const MirroredMemory&) = delete;
+
+  MirroredMemory(MirroredMemory&& other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  MirroredMemory& operator=(MirroredMemory&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = other.data_;
+      size_ = other.size_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * \brief Map at least minSize bytes twice. Releases a previous mapping.
+   *
+   * \return Whether the mapping was created. On failure, data() is nullptr and size() is 0.
+   */
+  bool map(const size_type minSize);
+
+  /**
+   * \brief Release the mapping. Does nothing if there is none.
+   */
+  void unmap();
+
+  /**
+   * \brief Start of the memory. The 2 * size() bytes starting here are accessible.
+   */
+  pointer_type data() const { return data_; }
+
+  /**
+   * \brief Size of the memory, not counting the mirror.
+   */
+  size_type size() const { return size_; }
+
+  /**
+   * \brief Granularity to which map() rounds up the requested size.
+   */
+  static size_type pageSize();
+
+ private:
+  pointer_type data_ = nullptr;
+  size_type size_ = 0;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__MIRROREDMEMORY_H__
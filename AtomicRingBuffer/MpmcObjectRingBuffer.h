@@ -0,0 +1,184 @@
+#ifndef __ATOMICRINGBUFFER__MPMCOBJECTRINGBUFFER_H__
+#define __ATOMICRINGBUFFER__MPMCOBJECTRINGBUFFER_H__
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+/*
+ * \brief Class MpmcObjectRingBuffer
+ *
+ * A bounded queue of objects for multiple producers and multiple consumers, following Dmitry Vyukov's bounded MPMC
+ * queue. Each slot carries a sequence number that tells whether it is free, being written, readable or being read, so
+ * producers and consumers only contend on the position counter of their own side.
+ *
+ * Only the single element operations of ObjectRingBuffer are offered, and with one difference: peek() claims the
+ * returned element for the calling consumer. Every successful peek() must be followed by exactly one consume() of the
+ * returned range, and calling peek() twice returns two different elements.
+ *
+ * publish() and consume() check the sequence number of the slot, so a range that was not claimed, or that was already
+ * published or consumed, is rejected instead of corrupting the queue.
+ */
+template <typename T, std::size_t elemCapacity, size_t alignment = alignof(T)>
+class MpmcObjectRingBuffer {
+ public:
+  // With a single slot, a consumed element and a published one have the same sequence number.
+  static_assert(elemCapacity > 1, "Capacity must be at least 2.");
+  static_assert((elemCapacity & (elemCapacity - 1)) == 0, "Capacity must be a power of two.");
+
+  using size_type = std::size_t;
+  using value_type = T;
+  using pointer_type = value_type*;
+
+  struct MemoryRange {
+    pointer_type ptr = nullptr;
+    size_type len = 0;
+
+    bool operator==(const MemoryRange& other) const { return ptr == other.ptr && len == other.len; }
+  };
+
+  MpmcObjectRingBuffer() {
+    for (size_type i = 0; i < elemCapacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * \brief Claim a free element for writing. Returns an empty range if the buffer is full.
+   */
+  MemoryRange allocate() {
+    size_type pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos & kIndexMask];
+      const size_type sequence = slot.sequence.load(std::memory_order_acquire);
+      const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return MemoryRange{reinterpret_cast<pointer_type>(&slot.storage), 1};
+        }
+      } else if (diff < 0) {
+        // The slot still holds an element from the previous round.
+        return MemoryRange{};
+      } else {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * \brief Make an allocated element available to the consumers.
+   *
+   * \return 1, or 0 if elemPtr was not allocated or has already been published.
+   */
+  size_type publish(const MemoryRange& elemPtr) {
+    Slot* slot = toSlot(elemPtr);
+    if (slot == nullptr) {
+      return 0;
+    }
+    // An allocated slot still has the sequence number of a free one, which equals the claimed position.
+    const size_type sequence = slot->sequence.load(std::memory_order_relaxed);
+    if (!isClaimed(*slot, sequence, enqueuePos_)) {
+      return 0;
+    }
+    slot->sequence.store(sequence + 1, std::memory_order_release);
+    return 1;
+  }
+
+  /**
+   * \brief Claim a published element for reading. Returns an empty range if the buffer is empty.
+   */
+  MemoryRange peek() {
+    size_type pos = dequeuePos_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos & kIndexMask];
+      const size_type sequence = slot.sequence.load(std::memory_order_acquire);
+      const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return MemoryRange{reinterpret_cast<pointer_type>(&slot.storage), 1};
+        }
+      } else if (diff < 0) {
+        // The slot has not been published yet.
+        return MemoryRange{};
+      } else {
+        pos = dequeuePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * \brief Hand a claimed element back to the producers.
+   *
+   * \return 1, or 0 if elemPtr was not returned by peek() or has already been consumed.
+   */
+  size_type consume(const MemoryRange& elemPtr) {
+    Slot* slot = toSlot(elemPtr);
+    if (slot == nullptr) {
+      return 0;
+    }
+    // A peeked slot still has the sequence number of a published one, which is one past the claimed position.
+    const size_type sequence = slot->sequence.load(std::memory_order_relaxed);
+    if (!isClaimed(*slot, sequence - 1, dequeuePos_)) {
+      return 0;
+    }
+    slot->sequence.store(sequence + elemCapacity - 1, std::memory_order_release);
+    return 1;
+  }
+
+  /**
+   * \brief Number of elements claimed by producers but not yet claimed by consumers. Only a snapshot.
+   */
+  size_type size() const {
+    const size_type dequeuePos = dequeuePos_.load(std::memory_order_relaxed);
+    return enqueuePos_.load(std::memory_order_relaxed) - dequeuePos;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  constexpr size_type capacity() const { return elemCapacity; }
+
+ private:
+  constexpr static size_type kIndexMask = elemCapacity - 1;
+
+  using buffer_element_type = typename std::aligned_storage<sizeof(value_type), alignment>::type;
+
+  struct Slot {
+    std::atomic_size_t sequence;
+    buffer_element_type storage;
+  };
+
+  Slot* toSlot(const MemoryRange& elemPtr) {
+    const uint8_t* const ptr = reinterpret_cast<const uint8_t*>(elemPtr.ptr);
+    const uint8_t* const first = reinterpret_cast<const uint8_t*>(&slots_[0].storage);
+    if (elemPtr.len != 1 || ptr < first || ptr > reinterpret_cast<const uint8_t*>(&slots_[kIndexMask].storage)) {
+      return nullptr;
+    }
+    const size_type offset = static_cast<size_type>(ptr - first);
+    if (offset % sizeof(Slot) != 0) {
+      return nullptr;
+    }
+    return &slots_[offset / sizeof(Slot)];
+  }
+
+  /**
+   * \brief Whether position belongs to slot and has been claimed from the position counter pos, i.e. it is one of
+   * the last elemCapacity positions handed out.
+   */
+  bool isClaimed(const Slot& slot, const size_type position, const std::atomic_size_t& pos) const {
+    return (position & kIndexMask) == static_cast<size_type>(&slot - slots_) &&
+           pos.load(std::memory_order_relaxed) - position - 1 < elemCapacity;
+  }
+
+  Slot slots_[elemCapacity];
+
+  alignas(kCacheLineSize) std::atomic_size_t enqueuePos_{0};
+  alignas(kCacheLineSize) std::atomic_size_t dequeuePos_{0};
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__MPMCOBJECTRINGBUFFER_H__
@@ -1,33 +1,68 @@
 #ifndef __ATOMICRINGBUFFER__STRUCTRINGBUFFER_H__
 #define __ATOMICRINGBUFFER__STRUCTRINGBUFFER_H__
 
+#include <cstring>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 #include "AtomicRingBuffer.h"
 
+// Without exception support, e.g. with -fno-exceptions, the rollback on a throwing constructor compiles to nothing.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ATOMICRINGBUFFER_TRY try
+#define ATOMICRINGBUFFER_CATCH_ALL catch (...)
+#define ATOMICRINGBUFFER_RETHROW throw
+#else
+#define ATOMICRINGBUFFER_TRY if (true)
+#define ATOMICRINGBUFFER_CATCH_ALL else
+#define ATOMICRINGBUFFER_RETHROW
+#endif
+
 namespace AtomicRingBuffer {
 
 /*
- * \brief Class ObjectRingBuffer
+ * \brief Class BasicObjectRingBuffer
+ *
+ * Passes objects of type T through storage that is provided at runtime, see init(). ObjectRingBuffer embeds its storage
+ * and DynamicObjectRingBuffer obtains it from an allocator. Other storage, e.g. from HugePageMemory, can be used
+ * directly:
+ *
+ *     HugePageMemory memory;
+ *     BasicObjectRingBuffer<Message> ringBuffer;
+ *     if (memory.map(numMessages * BasicObjectRingBuffer<Message>::kElementSize)) {
+ *       ringBuffer.init(memory.data(), memory.size() / BasicObjectRingBuffer<Message>::kElementSize);
+ *     }
+ *
+ * Traits configure the underlying BasicAtomicRingBuffer, e.g. its synchronization, statistics or tracing.
  */
-template <typename T, uint16_t elemCapacity, size_t alignment = alignof(T)>
-class ObjectRingBuffer {
+template <typename T, size_t alignment = alignof(T), typename Traits = DefaultTraits>
+class BasicObjectRingBuffer {
  public:
-  static_assert(elemCapacity > 0, "Cannot have Buffer with 0 capacity.");
+  static_assert(!Traits::Synchronization::kMultiProducer, "Multiple producers require a completion map.");
 
-  using Delegate_t = AtomicRingBuffer;
-  using size_type = Delegate_t::size_type;
+  using Delegate_t = BasicAtomicRingBuffer<Traits>;
+  using size_type = typename Delegate_t::size_type;
   using value_type = T;
   using pointer_type = value_type*;
 
- private:
+  /**
+   * \brief Storage of a single element. Storage passed to init() must be aligned like this type.
+   */
   using buffer_element_type = typename std::aligned_storage<sizeof(value_type), alignment>::type;
 
-  constexpr static Delegate_t::size_type toNumBytes(const size_type numElems) {
+  /**
+   * \brief Number of bytes of storage per element.
+   */
+  constexpr static size_type kElementSize = sizeof(buffer_element_type);
+
+ private:
+  constexpr static typename Delegate_t::size_type toNumBytes(const size_type numElems) {
     return numElems * sizeof(buffer_element_type);
   }
 
-  constexpr static Delegate_t::size_type toNumElements(const Delegate_t::size_type numBytes) {
+  constexpr static typename Delegate_t::size_type toNumElements(const typename Delegate_t::size_type numBytes) {
     return numBytes / sizeof(buffer_element_type);
   }
 
@@ -39,41 +74,376 @@ class ObjectRingBuffer {
     bool operator==(const MemoryRange& other) const { return ptr == other.ptr && len == other.len; }
   };
 
-  constexpr ObjectRingBuffer() : delegate(bytebuffer, kByteBufferSize) {}
+  /**
+   * \brief Up to two contiguous ranges of elements. If the elements wrap around the end of the buffer, second starts at
+   * the beginning of the buffer.
+   */
+  struct MemoryRangePair {
+    MemoryRange first;
+    MemoryRange second;
+
+    size_type len() const { return first.len + second.len; }
+
+    bool operator==(const MemoryRangePair& other) const { return first == other.first && second == other.second; }
+  };
+
+  constexpr BasicObjectRingBuffer() = default;
+
+  /**
+   * \brief Destroy the elements that are still in the buffer, as if they were popped.
+   *
+   * Elements that were added with allocate() or allocateSegments() but never constructed must not be left in a buffer
+   * of a type that is not trivially destructible.
+   */
+  ~BasicObjectRingBuffer() { destroyElements(); }
 
-  MemoryRange allocate() { return convertMemoryRange(delegate.allocate(toNumBytes(1), false)); }
+  BasicObjectRingBuffer(const BasicObjectRingBuffer&) = delete;
+  BasicObjectRingBuffer& operator=(const BasicObjectRingBuffer&) = delete;
+
+  /**
+   * \brief Use numElems elements of storage starting at storage. Discards all elements.
+   */
+  void init(void* storage, const size_type numElems) {
+    delegate.init(static_cast<typename Delegate_t::pointer_type>(storage), toNumBytes(numElems));
+  }
+
+  MemoryRange allocate() { return allocate(1, false); }
+
+  /**
+   * \brief Allocate up to numElems contiguous elements. See AtomicRingBuffer::allocate().
+   */
+  MemoryRange allocate(const size_type numElems, const bool partial_acceptable) {
+    return convertMemoryRange(delegate.allocate(toNumBytes(numElems), partial_acceptable));
+  }
+
+  /**
+   * \brief Allocate up to numElems elements, continuing at the beginning of the buffer if the first range ends at the
+   * end of the buffer.
+   *
+   * Both ranges must be published with publish(const MemoryRangePair&), which updates the write index only once.
+   */
+  MemoryRangePair allocateSegments(const size_type numElems) {
+    return convertMemoryRangePair(delegate.allocateSegments(toNumBytes(numElems), true));
+  }
 
   size_type publish(const MemoryRange& elemPtr) { return toNumElements(delegate.publish(convertMemoryRange(elemPtr))); }
 
-  const MemoryRange peek() const { return convertMemoryRange(delegate.peek(toNumBytes(1), false)); }
+  size_type publish(const MemoryRangePair& ranges) {
+    return toNumElements(delegate.publish(convertMemoryRangePair(ranges)));
+  }
+
+  const MemoryRange peek() const { return peek(1, false); }
+
+  /**
+   * \brief Obtain up to numElems contiguous published elements. See AtomicRingBuffer::peek().
+   */
+  const MemoryRange peek(const size_type numElems, const bool partial_acceptable) const {
+    return convertMemoryRange(delegate.peek(toNumBytes(numElems), partial_acceptable));
+  }
 
+  /**
+   * \brief Obtain up to numElems published elements, continuing at the beginning of the buffer if the first range ends
+   * at the end of the buffer.
+   */
+  const MemoryRangePair peekSegments(const size_type numElems) const {
+    return convertMemoryRangePair(delegate.peekSegments(toNumBytes(numElems), true));
+  }
+
+  /**
+   * \brief Free the space of elements. Does not run their destructors, see pop().
+   */
   size_type consume(const MemoryRange elemPtr) { return toNumElements(delegate.consume(convertMemoryRange(elemPtr))); }
 
+  size_type consume(const MemoryRangePair& ranges) {
+    return toNumElements(delegate.consume(convertMemoryRangePair(ranges)));
+  }
+
+  /**
+   * \brief Return the end of the most recent allocation to the buffer, keeping its first numElems elements. See
+   * AtomicRingBuffer::shrink().
+   */
+  bool shrink(const MemoryRange& elemPtr, const size_type numElems) {
+    return delegate.shrink(convertMemoryRange(elemPtr), toNumBytes(numElems));
+  }
+
+  /**
+   * \brief Like allocate(), but the elements are published when the returned lease goes out of scope.
+   */
+  WriteLease<BasicObjectRingBuffer> allocateLease(const size_type numElems, const bool partial_acceptable) {
+    return WriteLease<BasicObjectRingBuffer>(*this, allocate(numElems, partial_acceptable));
+  }
+
+  /**
+   * \brief Like peek(), but the elements are consumed when the returned lease goes out of scope.
+   */
+  ReadLease<BasicObjectRingBuffer> peekLease(const size_type numElems, const bool partial_acceptable) {
+    return ReadLease<BasicObjectRingBuffer>(*this, peek(numElems, partial_acceptable));
+  }
+
+  /**
+   * \brief Construct an element from args directly in the buffer and publish it.
+   *
+   * If the constructor throws, the space is returned to the buffer before the exception is rethrown.
+   *
+   * \return Whether there was space for the element.
+   */
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    const MemoryRange mem = allocate(1, false);
+    if (mem.len == 0) {
+      return false;
+    }
+    ATOMICRINGBUFFER_TRY { new (mem.ptr) value_type(std::forward<Args>(args)...); }
+    ATOMICRINGBUFFER_CATCH_ALL {
+      shrink(mem, 0);
+      ATOMICRINGBUFFER_RETHROW;
+    }
+    publish(mem);
+    return true;
+  }
+
+  bool push(const value_type& value) { return emplace(value); }
+
+  bool push(value_type&& value) { return emplace(std::move(value)); }
+
+  /**
+   * \brief Copy up to numElems elements into the buffer. Trivially copyable elements are copied using memcpy().
+   *
+   * If a copy constructor throws, the elements copied before are published, the rest of the space is returned to the
+   * buffer and the exception is rethrown.
+   *
+   * \return The number of elements pushed.
+   */
+  size_type push(const value_type* values, const size_type numElems) {
+    const MemoryRangePair mem = allocateSegments(numElems);
+    if (mem.first.len == 0) {
+      return 0;
+    }
+    size_type numConstructed = 0;
+    ATOMICRINGBUFFER_TRY {
+      copyConstruct(mem.first.ptr, values, mem.first.len, numConstructed, std::is_trivially_copyable<value_type>{});
+      copyConstruct(mem.second.ptr, values + mem.first.len, mem.second.len, numConstructed,
+                    std::is_trivially_copyable<value_type>{});
+    }
+    ATOMICRINGBUFFER_CATCH_ALL {
+      publishConstructed(mem, numConstructed);
+      ATOMICRINGBUFFER_RETHROW;
+    }
+    return publish(mem);
+  }
+
+  /**
+   * \brief The oldest element, or nullptr if the buffer is empty. Remains valid until it is popped or consumed.
+   */
+  pointer_type front() const { return peek(1, false).ptr; }
+
+  /**
+   * \brief Destroy the oldest element and free its space.
+   *
+   * Unlike consume(), which only frees the space, pop() runs the destructor.
+   *
+   * \return Whether there was an element.
+   */
+  bool pop() {
+    const MemoryRange mem = peek(1, false);
+    if (mem.len == 0) {
+      return false;
+    }
+    mem.ptr->~value_type();
+    consume(mem);
+    return true;
+  }
+
+  /**
+   * \brief Move the oldest element to value, then destroy it and free its space.
+   *
+   * \return Whether there was an element.
+   */
+  bool pop(value_type& value) {
+    const MemoryRange mem = peek(1, false);
+    if (mem.len == 0) {
+      return false;
+    }
+    moveOut(&value, mem.ptr, 1, std::is_trivially_copyable<value_type>{});
+    consume(mem);
+    return true;
+  }
+
+  /**
+   * \brief Move up to numElems of the oldest elements to values, then destroy them and free their space. Trivially
+   * copyable elements are copied using memcpy().
+   *
+   * \return The number of elements popped.
+   */
+  size_type pop(value_type* values, const size_type numElems) {
+    const MemoryRangePair mem = peekSegments(numElems);
+    moveOut(values, mem.first.ptr, mem.first.len, std::is_trivially_copyable<value_type>{});
+    moveOut(values + mem.first.len, mem.second.ptr, mem.second.len, std::is_trivially_copyable<value_type>{});
+    return consume(mem);
+  }
+
   size_type size() const { return toNumElements(delegate.size()); }
 
   bool empty() const { return delegate.empty(); }
 
   size_type capacity() const { return toNumElements(delegate.capacity()); }
 
+  /**
+   * \brief Counters of the underlying buffer in bytes, see BasicAtomicRingBuffer::statistics().
+   */
+  BufferStatistics statistics() const { return delegate.statistics(); }
+
+ protected:
+  constexpr BasicObjectRingBuffer(typename Delegate_t::pointer_type storage, const size_type numElems)
+      : delegate(storage, toNumBytes(numElems)) {}
+
+  /**
+   * \brief Pop all elements. Must be called by derived classes that release the storage before this class is destroyed.
+   */
+  void destroyElements() {
+    if (!std::is_trivially_destructible<value_type>::value) {
+      while (pop()) {
+      }
+    }
+  }
+
  private:
-  constexpr static const size_type kByteBufferSize = ObjectRingBuffer::toNumBytes(elemCapacity);
+  static void copyConstruct(pointer_type dest, const value_type* src, const size_type numElems,
+                            size_type& numConstructed, std::true_type) {
+    if (numElems == 0) {
+      return;
+    }
+    memcpy(static_cast<void*>(dest), src, numElems * sizeof(value_type));
+    numConstructed += numElems;
+  }
+
+  static void copyConstruct(pointer_type dest, const value_type* src, const size_type numElems,
+                            size_type& numConstructed, std::false_type) {
+    for (size_type i = 0; i < numElems; ++i) {
+      new (dest + i) value_type(src[i]);
+      ++numConstructed;
+    }
+  }
+
+  /**
+   * \brief Publish the first numConstructed elements of an allocation made by allocateSegments() and return the rest.
+   */
+  void publishConstructed(const MemoryRangePair& mem, const size_type numConstructed) {
+    if (numConstructed < mem.first.len) {
+      // The second range ends at the allocate index and must be returned first.
+      shrink(mem.second, 0);
+      shrink(mem.first, numConstructed);
+      if (numConstructed > 0) {
+        publish(MemoryRange{mem.first.ptr, numConstructed});
+      }
+    } else {
+      const MemoryRange second{mem.second.ptr, numConstructed - mem.first.len};
+      shrink(mem.second, second.len);
+      publish(MemoryRangePair{mem.first, second});
+    }
+  }
 
-  using ByteBuffer_t = uint8_t[kByteBufferSize];
+  static void moveOut(value_type* dest, pointer_type src, const size_type numElems, std::true_type) {
+    if (numElems == 0) {
+      return;
+    }
+    memcpy(static_cast<void*>(dest), src, numElems * sizeof(value_type));
+  }
+
+  static void moveOut(value_type* dest, pointer_type src, const size_type numElems, std::false_type) {
+    for (size_type i = 0; i < numElems; ++i) {
+      dest[i] = std::move(src[i]);
+      src[i].~value_type();
+    }
+  }
 
-  constexpr static MemoryRange convertMemoryRange(const Delegate_t::MemoryRange& delegateRange) {
+  constexpr static MemoryRange convertMemoryRange(const typename Delegate_t::MemoryRange& delegateRange) {
     const auto len = toNumElements(delegateRange.len);
     return MemoryRange{reinterpret_cast<pointer_type>(delegateRange.ptr), len};
   }
 
-  constexpr static Delegate_t::MemoryRange convertMemoryRange(const MemoryRange& myRange) {
-    return Delegate_t::MemoryRange{reinterpret_cast<Delegate_t::pointer_type>(myRange.ptr), toNumBytes(myRange.len)};
+  constexpr static typename Delegate_t::MemoryRange convertMemoryRange(const MemoryRange& myRange) {
+    return typename Delegate_t::MemoryRange{reinterpret_cast<typename Delegate_t::pointer_type>(myRange.ptr),
+                                            toNumBytes(myRange.len)};
   }
 
-  ByteBuffer_t bytebuffer alignas(buffer_element_type);
+  constexpr static MemoryRangePair convertMemoryRangePair(const typename Delegate_t::MemoryRangePair& delegateRanges) {
+    return MemoryRangePair{convertMemoryRange(delegateRanges.first), convertMemoryRange(delegateRanges.second)};
+  }
+
+  constexpr static typename Delegate_t::MemoryRangePair convertMemoryRangePair(const MemoryRangePair& myRanges) {
+    return typename Delegate_t::MemoryRangePair{convertMemoryRange(myRanges.first),
+                                                convertMemoryRange(myRanges.second)};
+  }
 
   Delegate_t delegate;
 };
 
+template <typename T, size_t alignment, typename Traits>
+constexpr typename BasicObjectRingBuffer<T, alignment, Traits>::size_type
+    BasicObjectRingBuffer<T, alignment, Traits>::kElementSize;
+
+/*
+ * \brief Class ObjectRingBuffer
+ *
+ * A BasicObjectRingBuffer that contains its own storage for elemCapacity elements.
+ */
+template <typename T, std::size_t elemCapacity, size_t alignment = alignof(T), typename Traits = DefaultTraits>
+class ObjectRingBuffer : public BasicObjectRingBuffer<T, alignment, Traits> {
+ public:
+  static_assert(elemCapacity > 0, "Cannot have Buffer with 0 capacity.");
+
+  using Base_t = BasicObjectRingBuffer<T, alignment, Traits>;
+  using buffer_element_type = typename Base_t::buffer_element_type;
+
+  constexpr ObjectRingBuffer() : Base_t(bytebuffer, elemCapacity) {}
+
+ private:
+  // The base class only stores the address, so the storage does not have to be constructed before it.
+  alignas(buffer_element_type) uint8_t bytebuffer[elemCapacity * sizeof(buffer_element_type)];
+};
+
+/*
+ * \brief Class DynamicObjectRingBuffer
+ *
+ * A BasicObjectRingBuffer whose storage for a number of elements chosen at runtime is obtained from an allocator. The
+ * allocator is rebound to BasicObjectRingBuffer::buffer_element_type. Before C++17, std::allocator does not respect
+ * alignments beyond alignof(std::max_align_t).
+ */
+template <typename T, typename Allocator = std::allocator<T>, typename Traits = DefaultTraits>
+class DynamicObjectRingBuffer : public BasicObjectRingBuffer<T, alignof(T), Traits> {
+ public:
+  using Base_t = BasicObjectRingBuffer<T, alignof(T), Traits>;
+  using size_type = typename Base_t::size_type;
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<typename Base_t::buffer_element_type>;
+
+  explicit DynamicObjectRingBuffer(const size_type numElems, const Allocator& allocator = Allocator())
+      : allocator_(allocator), numElems_(numElems) {
+    storage_ = std::allocator_traits<allocator_type>::allocate(allocator_, numElems_);
+    this->init(storage_, numElems_);
+  }
+
+  DynamicObjectRingBuffer(const DynamicObjectRingBuffer&) = delete;
+  DynamicObjectRingBuffer& operator=(const DynamicObjectRingBuffer&) = delete;
+
+  ~DynamicObjectRingBuffer() {
+    this->destroyElements();
+    std::allocator_traits<allocator_type>::deallocate(allocator_, storage_, numElems_);
+  }
+
+ private:
+  using storage_pointer = typename std::allocator_traits<allocator_type>::pointer;
+
+  allocator_type allocator_;
+  size_type numElems_;
+  storage_pointer storage_;
+};
+
 }  // namespace AtomicRingBuffer
 
+#undef ATOMICRINGBUFFER_TRY
+#undef ATOMICRINGBUFFER_CATCH_ALL
+#undef ATOMICRINGBUFFER_RETHROW
+
 #endif  // __ATOMICRINGBUFFER__STRUCTRINGBUFFER_H__
@@ -0,0 +1,174 @@
+#ifndef __ATOMICRINGBUFFER__STATICATOMICRINGBUFFER_H__
+#define __ATOMICRINGBUFFER__STATICATOMICRINGBUFFER_H__
+
+#include "AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief An AtomicRingBuffer with a compile-time capacity that is a power of two and that contains its own storage.
+ *
+ * Offers the core interface of BasicAtomicRingBuffer: allocate(), publish(), peek(), consume(), size(), empty() and
+ * capacity(). Segments, leases, shrink(), statistics and tracing are not available, and neither are multiple producers
+ * or mirrored storage. Traits that ask for any of these are rejected at compile time. As the capacity divides the range
+ * of size_type, indices are free-running and only masked when accessing the buffer. This removes the doubled index
+ * range and most of the branches from allocate, publish, peek and consume.
+ *
+ * Class invariant: readIdx <= writeIdx <= allocateIdx <= readIdx + kCapacity, modulo the range of size_type.
+ */
+template <std::size_t kCapacity, typename Traits = DefaultTraits>
+class StaticAtomicRingBuffer {
+ public:
+  static_assert(kCapacity > 0, "Cannot have Buffer with 0 capacity.");
+  static_assert((kCapacity & (kCapacity - 1)) == 0, "Capacity must be a power of two.");
+  static_assert(!Traits::Synchronization::kMultiProducer, "Use BasicAtomicRingBuffer for multiple producers.");
+  static_assert(!Traits::kMirroredBuffer, "Use BasicAtomicRingBuffer with MirroredMemory for a mirrored buffer.");
+  static_assert(!Traits::Statistics::kCountOperations && !Traits::Statistics::kTrackHighWaterMark &&
+                    !Traits::Statistics::kSampleFillLevel,
+                "Use BasicAtomicRingBuffer for statistics.");
+  static_assert(!Traits::Tracing::kEnabled, "Use BasicAtomicRingBuffer for tracing.");
+
+  using value_type = uint8_t;
+  using pointer_type = value_type *;
+  using size_type = std::size_t;
+  using atomic_size_type = std::atomic_size_t;
+  using traits_type = Traits;
+  using Sync = typename Traits::Synchronization;
+
+  struct MemoryRange {
+    pointer_type ptr = nullptr;
+    size_type len = 0;
+
+    bool operator==(const MemoryRange &other) const { return ptr == other.ptr && len == other.len; }
+  };
+
+  constexpr StaticAtomicRingBuffer() = default;
+
+  /**
+   * Get as many elements as requested without wraparound. See BasicAtomicRingBuffer::allocate().
+   */
+  MemoryRange allocate(const size_type numElems, const bool partial_acceptable) {
+    size_type origAllocateIdx = Sync::loadOwn(allocateIdx_);
+    MemoryRange allocatedMemory;
+    if (Traits::kCacheOppositeIndex) {
+      allocatedMemory = allocate(origAllocateIdx, kCapacity - (origAllocateIdx - cachedReadIdx_), numElems,
+                                 partial_acceptable);
+      if (allocatedMemory.len < numElems) {
+        cachedReadIdx_ = Sync::loadOther(readIdx_);
+        allocatedMemory = allocate(origAllocateIdx, kCapacity - (origAllocateIdx - cachedReadIdx_), numElems,
+                                   partial_acceptable);
+      }
+    } else {
+      allocatedMemory = allocate(origAllocateIdx, kCapacity - (origAllocateIdx - Sync::loadOther(readIdx_)),
+                                 numElems, partial_acceptable);
+    }
+
+    if (allocatedMemory.len == 0 ||
+        !Sync::reserve(allocateIdx_, origAllocateIdx, origAllocateIdx + allocatedMemory.len)) {
+      allocatedMemory = MemoryRange{};
+    }
+    return allocatedMemory;
+  }
+
+  /**
+   * Sends of allocated bytes. See BasicAtomicRingBuffer::publish().
+   */
+  size_type publish(const MemoryRange data) { return commit(writeIdx_, Sync::loadOwn(allocateIdx_), data); }
+
+  /**
+   * Returns pointer and length to available data. See BasicAtomicRingBuffer::peek().
+   */
+  MemoryRange peek(const size_type len, const bool partial_acceptable) const {
+    const size_type currentReadIdx = Sync::loadOwn(readIdx_);
+    if (Traits::kCacheOppositeIndex) {
+      MemoryRange memory = allocate(currentReadIdx, cachedWriteIdx_ - currentReadIdx, len, partial_acceptable);
+      if (memory.len < len) {
+        cachedWriteIdx_ = Sync::loadOther(writeIdx_);
+        memory = allocate(currentReadIdx, cachedWriteIdx_ - currentReadIdx, len, partial_acceptable);
+      }
+      return memory;
+    } else {
+      return allocate(currentReadIdx, Sync::loadOther(writeIdx_) - currentReadIdx, len, partial_acceptable);
+    }
+  }
+
+  /**
+   * Free up space in the buffer. See BasicAtomicRingBuffer::consume().
+   */
+  size_type consume(const MemoryRange data) {
+    return commit(readIdx_, (Traits::kCacheOppositeIndex ? cachedWriteIdx_ : Sync::loadOther(writeIdx_)), data);
+  }
+
+  constexpr size_type capacity() const { return kCapacity; }
+
+  size_type size() const {
+    const size_type currentReadIdx = readIdx_;
+    return writeIdx_ - currentReadIdx;
+  }
+
+  bool empty() const { return readIdx_ == writeIdx_; }
+
+ private:
+  constexpr static size_type kIndexMask = kCapacity - 1;
+
+  constexpr static size_type toBufferIdx(const size_type idx) { return idx & kIndexMask; }
+
+  constexpr static size_type bytesRemainingInBuffer(const size_type idx) { return kCapacity - toBufferIdx(idx); }
+
+  /**
+   * \brief Hand out memory starting at sectionBegin, given that sectionLen bytes are available in total.
+   */
+  MemoryRange allocate(const size_type sectionBegin, const size_type sectionLen, const size_type len,
+                       const bool partial_acceptable) const {
+    MemoryRange memory;
+    const size_type dataAvailable = detail::min(sectionLen, bytesRemainingInBuffer(sectionBegin));
+    if (dataAvailable != 0 && (dataAvailable >= len || partial_acceptable)) {
+      memory.len = detail::min(len, dataAvailable);
+      memory.ptr = const_cast<pointer_type>(&buffer_[toBufferIdx(sectionBegin)]);
+    }
+    return memory;
+  }
+
+  size_type commit(atomic_size_type &sectionBegin, const size_type sectionEnd, const MemoryRange data) {
+    if (buffer_ <= data.ptr && data.ptr < &buffer_[kCapacity]) {
+      size_type currentIdx = Sync::loadOwn(sectionBegin);
+      if (static_cast<size_type>(data.ptr - buffer_) != toBufferIdx(currentIdx)) {
+        // Reject out-of-order commit
+        return 0;
+      }
+
+      const size_type numCommitableElems = detail::min(sectionEnd - currentIdx, bytesRemainingInBuffer(currentIdx));
+      const size_type commitedLen = detail::min(data.len, numCommitableElems);
+
+      if (Sync::update(sectionBegin, currentIdx, currentIdx + commitedLen)) {
+        return commitedLen;
+      }
+    }
+    return 0;
+  }
+
+  // Producer-owned indices.
+
+  // Until where can be read
+  alignas(Traits::kIndexAlignment) atomic_size_type writeIdx_{0};
+
+  // Until where elements have been allocated
+  atomic_size_type allocateIdx_{0};
+
+  // Last value of readIdx_ seen by the producer. Only used when caching the opposite index.
+  size_type cachedReadIdx_{0};
+
+  // Consumer-owned indices.
+
+  // From where can be read
+  alignas(Traits::kIndexAlignment) atomic_size_type readIdx_{0};
+
+  // Last value of writeIdx_ seen by the consumer. Only used when caching the opposite index.
+  mutable size_type cachedWriteIdx_{0};
+
+  alignas(Traits::kIndexAlignment) value_type buffer_[kCapacity];
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__STATICATOMICRINGBUFFER_H__
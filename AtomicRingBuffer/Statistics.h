@@ -0,0 +1,288 @@
+#ifndef __ATOMICRINGBUFFER__STATISTICS_H__
+#define __ATOMICRINGBUFFER__STATISTICS_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Counters of one kind of operation on a BasicAtomicRingBuffer.
+ */
+struct OperationStatistics {
+  /// Number of successful calls.
+  uint64_t count = 0;
+
+  /// Number of bytes allocated, published, peeked or consumed by the successful calls.
+  uint64_t bytes = 0;
+
+  /**
+   * Number of calls that failed because the buffer was full (allocate), empty (peek) or because the range was not the
+   * next one in order (publish, consume).
+   */
+  uint64_t rejected = 0;
+
+  /// Number of index updates that lost a race against a concurrent caller on the same side.
+  uint64_t casFailures = 0;
+};
+
+/**
+ * \brief Number of buckets of the fill level histogram, see BufferStatistics::fillHistogram.
+ */
+constexpr std::size_t kFillHistogramBuckets = 16;
+
+/**
+ * \brief Snapshot of the counters of a BasicAtomicRingBuffer, see BasicAtomicRingBuffer::statistics().
+ *
+ * The counters of each side are read individually and without synchronizing with the buffer, so a snapshot taken
+ * while the buffer is in use is only approximately consistent.
+ */
+struct BufferStatistics {
+  OperationStatistics allocate;
+  OperationStatistics publish;
+  OperationStatistics peek;
+  OperationStatistics consume;
+
+  /// Largest number of bytes in use, as seen by the producer right after an allocation.
+  uint64_t highWaterMark = 0;
+
+  /**
+   * Number of allocations after which the fill level was in each range. Bucket i counts fill levels from
+   * i * capacity / kFillHistogramBuckets up to, but excluding, (i + 1) * capacity / kFillHistogramBuckets. A full
+   * buffer counts towards the last bucket.
+   */
+  std::array<uint64_t, kFillHistogramBuckets> fillHistogram{};
+};
+
+/**
+ * \brief Statistics policy that records nothing. The counters take no space and every update compiles to nothing.
+ *
+ * To record only some statistics, derive from NoStatistics and shadow the respective members.
+ */
+struct NoStatistics {
+  /// Whether to count calls, bytes, rejections and compare-and-swap failures of each operation.
+  static constexpr bool kCountOperations = false;
+
+  /// Whether to track BufferStatistics::highWaterMark.
+  static constexpr bool kTrackHighWaterMark = false;
+
+  /// Whether to sample the fill level into BufferStatistics::fillHistogram on every allocation.
+  static constexpr bool kSampleFillLevel = false;
+};
+
+/**
+ * \brief Statistics policy that counts every operation and tracks the high-water mark.
+ *
+ * The producer counters and the consumer counters are placed on separate cache lines and are only written by their
+ * own side, so counting does not add cache line transfers between producer and consumer. With a single thread per
+ * side, counters are updated using plain relaxed stores. Otherwise, they use relaxed atomic additions.
+ */
+struct CountingStatistics : public NoStatistics {
+  static constexpr bool kCountOperations = true;
+  static constexpr bool kTrackHighWaterMark = true;
+};
+
+/**
+ * \brief Statistics policy that only records how full the buffer gets: the high-water mark and the fill histogram.
+ *
+ * Both are updated by the producer when it allocates, using the read index it loads anyway. This costs a comparison and
+ * an increment per allocation, but no additional cache line transfer. With kCacheOppositeIndex, the cached read index
+ * may be outdated, so the producer loads the read index once more per allocation to sample the actual fill level.
+ */
+struct OccupancyStatistics : public NoStatistics {
+  static constexpr bool kTrackHighWaterMark = true;
+  static constexpr bool kSampleFillLevel = true;
+};
+
+namespace detail {
+
+enum class Operation { kAllocate, kPublish, kPeek, kConsume };
+
+/**
+ * \brief Counters of a BasicAtomicRingBuffer. The disabled variant is empty and does nothing.
+ *
+ * All functions are const, as peek() counts as well. The counters of each side are aligned to kSideAlignment.
+ */
+template <bool kEnabled, bool kSharedProducer, bool kSharedConsumer, std::size_t kSideAlignment>
+class StatisticsCounters {
+ public:
+  void countSuccess(Operation, std::size_t) const {}
+  void countRejected(Operation) const {}
+  void countCasFailure(Operation) const {}
+
+  void snapshotOperations(BufferStatistics &) const {}
+  void resetOperations() {}
+};
+
+template <bool kSharedProducer, bool kSharedConsumer, std::size_t kSideAlignment>
+class StatisticsCounters<true, kSharedProducer, kSharedConsumer, kSideAlignment> {
+ public:
+  void countSuccess(const Operation op, const std::size_t bytes) const {
+    Counters &counters = countersOf(op);
+    add(op, counters.count, 1);
+    add(op, counters.bytes, bytes);
+  }
+
+  void countRejected(const Operation op) const { add(op, countersOf(op).rejected, 1); }
+
+  void countCasFailure(const Operation op) const { add(op, countersOf(op).casFailures, 1); }
+
+  void snapshotOperations(BufferStatistics &statistics) const {
+    statistics.allocate = load(producer_.allocate);
+    statistics.publish = load(producer_.publish);
+    statistics.peek = load(consumer_.peek);
+    statistics.consume = load(consumer_.consume);
+  }
+
+  /**
+   * \brief Set all counters to zero. Must not be called concurrently with operations on the buffer.
+   */
+  void resetOperations() {
+    for (Counters *counters : {&producer_.allocate, &producer_.publish, &consumer_.peek, &consumer_.consume}) {
+      counters->count.store(0, std::memory_order_relaxed);
+      counters->bytes.store(0, std::memory_order_relaxed);
+      counters->rejected.store(0, std::memory_order_relaxed);
+      counters->casFailures.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  using counter_type = std::atomic<uint64_t>;
+
+  struct Counters {
+    counter_type count{0};
+    counter_type bytes{0};
+    counter_type rejected{0};
+    counter_type casFailures{0};
+  };
+
+  Counters &countersOf(const Operation op) const {
+    switch (op) {
+      case Operation::kAllocate:
+        return producer_.allocate;
+      case Operation::kPublish:
+        return producer_.publish;
+      case Operation::kPeek:
+        return consumer_.peek;
+      default:
+        return consumer_.consume;
+    }
+  }
+
+  static void add(const Operation op, counter_type &counter, const uint64_t value) {
+    const bool shared = (op == Operation::kAllocate || op == Operation::kPublish) ? kSharedProducer : kSharedConsumer;
+    if (shared) {
+      counter.fetch_add(value, std::memory_order_relaxed);
+    } else {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+  }
+
+  static OperationStatistics load(const Counters &counters) {
+    OperationStatistics statistics;
+    statistics.count = counters.count.load(std::memory_order_relaxed);
+    statistics.bytes = counters.bytes.load(std::memory_order_relaxed);
+    statistics.rejected = counters.rejected.load(std::memory_order_relaxed);
+    statistics.casFailures = counters.casFailures.load(std::memory_order_relaxed);
+    return statistics;
+  }
+
+  struct alignas(kSideAlignment) ProducerCounters {
+    Counters allocate;
+    Counters publish;
+  };
+
+  struct alignas(kSideAlignment) ConsumerCounters {
+    Counters peek;
+    Counters consume;
+  };
+
+  mutable ProducerCounters producer_;
+  mutable ConsumerCounters consumer_;
+};
+
+/**
+ * \brief High-water mark and fill level histogram of a BasicAtomicRingBuffer. Only written by the producer. The variant
+ * that tracks neither is empty and does nothing.
+ */
+template <bool kHighWaterMark, bool kFillHistogram, bool kSharedProducer, std::size_t kSideAlignment>
+class OccupancyCounters {
+ public:
+  void sampleFillLevel(const std::size_t fillLevel, const std::size_t capacity) const {
+    if (kHighWaterMark) {
+      raiseHighWaterMark(fillLevel);
+    }
+    if (kFillHistogram && capacity != 0) {
+      const std::size_t bucket = fillLevel * kFillHistogramBuckets / capacity;
+      add(counters_.histogram[(bucket < kFillHistogramBuckets) ? bucket : kFillHistogramBuckets - 1]);
+    }
+  }
+
+  void snapshotOccupancy(BufferStatistics &statistics) const {
+    statistics.highWaterMark = counters_.highWaterMark.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < counters_.histogram.size(); ++i) {
+      statistics.fillHistogram[i] = counters_.histogram[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * \brief Set the high-water mark and the histogram to zero. Must not be called concurrently with operations on the
+   * buffer.
+   */
+  void resetOccupancy() {
+    counters_.highWaterMark.store(0, std::memory_order_relaxed);
+    for (counter_type &bucket : counters_.histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  using counter_type = std::atomic<uint64_t>;
+
+  void raiseHighWaterMark(const uint64_t fillLevel) const {
+    uint64_t current = counters_.highWaterMark.load(std::memory_order_relaxed);
+    if (fillLevel <= current) {
+      return;
+    }
+    if (kSharedProducer) {
+      while (current < fillLevel &&
+             !counters_.highWaterMark.compare_exchange_weak(current, fillLevel, std::memory_order_relaxed)) {
+      }
+    } else {
+      counters_.highWaterMark.store(fillLevel, std::memory_order_relaxed);
+    }
+  }
+
+  static void add(counter_type &counter) {
+    if (kSharedProducer) {
+      counter.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+  }
+
+  struct alignas(kSideAlignment) Counters {
+    counter_type highWaterMark{0};
+    std::array<counter_type, kFillHistogram ? kFillHistogramBuckets : 0> histogram{};
+  };
+
+  mutable Counters counters_;
+};
+
+template <bool kSharedProducer, std::size_t kSideAlignment>
+class OccupancyCounters<false, false, kSharedProducer, kSideAlignment> {
+ public:
+  void sampleFillLevel(std::size_t, std::size_t) const {}
+
+  void snapshotOccupancy(BufferStatistics &) const {}
+  void resetOccupancy() {}
+};
+
+}  // namespace detail
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__STATISTICS_H__
@@ -1,11 +1,47 @@
 #include "AtomicRingBuffer/StringCopyHelper.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ATOMICRINGBUFFER_HAS_SSE2 1
+#include <emmintrin.h>
+// AVX2 kernels are compiled using target attributes, which are only available with GCC and Clang.
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMICRINGBUFFER_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define ATOMICRINGBUFFER_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 namespace AtomicRingBuffer {
 
-memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const char search, const char* const replace,
-                                          const size_t destLen, const size_t srcLen) {
+namespace {
+
+/**
+ * \brief Index of the lowest set bit. value must not be 0.
+ */
+inline unsigned countTrailingZeros(const uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index = 0;
+  _BitScanForward64(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+memcpyCharReplaceResult memcpyCharReplaceScalar(char* dest, const char* src, const char search,
+                                                const char* const replace, const size_t destLen, const size_t srcLen) {
   memcpyCharReplaceResult result;
 
   // Check preconditions
@@ -74,4 +110,478 @@ memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const cha
   return result;
 }
 
+/**
+ * \brief Write as much of replace as fits before destEnd. Sets result.partialReplace if replace does not fit.
+ *
+ * \return Whether replace was written completely.
+ */
+inline bool insertReplacement(char*& dest, char* const destEnd, const char* const replace, const std::size_t replaceLen,
+                              memcpyCharReplaceResult& result) {
+  const std::size_t bytesToInsert = std::min(replaceLen, static_cast<std::size_t>(std::distance(dest, destEnd)));
+  if (bytesToInsert <= 8) {
+    // Escape sequences are short, copying them byte by byte is cheaper than calling memcpy().
+    for (std::size_t i = 0; i < bytesToInsert; ++i) {
+      dest[i] = replace[i];
+    }
+  } else {
+    memcpy(dest, replace, bytesToInsert);
+  }
+  std::advance(dest, bytesToInsert);
+  if (bytesToInsert != replaceLen) {
+    result.partialReplace = std::next(replace, bytesToInsert);
+    return false;
+  }
+  return true;
+}
+
+memcpyCharReplaceResult memcpyCharReplaceTableScalar(char* dest, const char* src, const CharReplaceTable& table,
+                                                     const size_t destLen, const size_t srcLen) {
+  memcpyCharReplaceResult result;
+  if (src == nullptr || dest == nullptr || srcLen == 0 || destLen == 0) {
+    return result;
+  }
+
+  if (table.empty()) {
+    result.len = std::min(destLen, srcLen);
+    memcpy(dest, src, result.len);
+    result.nextByte = std::next(dest, result.len);
+    return result;
+  }
+
+  const char* const srcBegin = src;
+  const char* const srcEnd = std::next(src, srcLen);
+  char* const destEnd = std::next(dest, destLen);
+
+  while (dest < destEnd && src < srcEnd) {
+    const char c = *src;
+    const char* const replace = table.replacement(c);
+    std::advance(src, 1);
+    if (replace == nullptr) {
+      *dest = c;
+      std::advance(dest, 1);
+    } else if (!insertReplacement(dest, destEnd, replace, table.replacementLen(c), result)) {
+      break;
+    }
+  }
+
+  result.len = std::distance(srcBegin, src);
+  result.nextByte = dest;
+  return result;
+}
+
+std::size_t memcpyUntilScalar(char* dest, const char* src, const char stop, const std::size_t len) {
+  const char* const found = static_cast<const char*>(memchr(src, stop, len));
+  const std::size_t run = (found != nullptr) ? static_cast<std::size_t>(std::distance(src, found)) : len;
+  memcpy(dest, src, run);
+  return run;
+}
+
+#ifdef ATOMICRINGBUFFER_HAS_SSE2
+namespace sse2 {
+
+struct Bytes {
+  static constexpr std::size_t kWidth = 16;
+  static constexpr unsigned kMaskBitsPerByte = 1;
+  using Block = __m128i;
+
+  static Block load(const char* src) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)); }
+  static void store(char* dest, const Block block) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), block); }
+  static Block splat(const char value) { return _mm_set1_epi8(value); }
+  static Block equal(const Block left, const Block right) { return _mm_cmpeq_epi8(left, right); }
+  static Block either(const Block left, const Block right) { return _mm_or_si128(left, right); }
+  static Block below(const Block block, const Block limit) {
+    // There is no unsigned comparison, so flip the sign bits and compare signed.
+    const Block bias = _mm_set1_epi8(static_cast<char>(0x80));
+    return _mm_cmplt_epi8(_mm_xor_si128(block, bias), _mm_xor_si128(limit, bias));
+  }
+  static uint64_t mask(const Block block) { return static_cast<uint32_t>(_mm_movemask_epi8(block)); }
+};
+
+#include "StringCopyKernels.inc"
+
+}  // namespace sse2
+#endif
+
+#ifdef ATOMICRINGBUFFER_HAS_AVX2
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+struct Bytes {
+  static constexpr std::size_t kWidth = 32;
+  static constexpr unsigned kMaskBitsPerByte = 1;
+  using Block = __m256i;
+
+  static Block load(const char* src) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)); }
+  static void store(char* dest, const Block block) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), block); }
+  static Block splat(const char value) { return _mm256_set1_epi8(value); }
+  static Block equal(const Block left, const Block right) { return _mm256_cmpeq_epi8(left, right); }
+  static Block either(const Block left, const Block right) { return _mm256_or_si256(left, right); }
+  static Block below(const Block block, const Block limit) {
+    const Block bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    return _mm256_cmpgt_epi8(_mm256_xor_si256(limit, bias), _mm256_xor_si256(block, bias));
+  }
+  static uint64_t mask(const Block block) { return static_cast<uint32_t>(_mm256_movemask_epi8(block)); }
+};
+
+#include "StringCopyKernels.inc"
+
+}  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
+
+#ifdef ATOMICRINGBUFFER_HAS_NEON
+namespace neon {
+
+struct Bytes {
+  static constexpr std::size_t kWidth = 16;
+  // NEON has no movemask. Narrowing each 16 bit lane by 4 bits leaves one nibble per byte.
+  static constexpr unsigned kMaskBitsPerByte = 4;
+  using Block = uint8x16_t;
+
+  static Block load(const char* src) { return vld1q_u8(reinterpret_cast<const uint8_t*>(src)); }
+  static void store(char* dest, const Block block) { vst1q_u8(reinterpret_cast<uint8_t*>(dest), block); }
+  static Block splat(const char value) { return vdupq_n_u8(static_cast<uint8_t>(value)); }
+  static Block equal(const Block left, const Block right) { return vceqq_u8(left, right); }
+  static Block either(const Block left, const Block right) { return vorrq_u8(left, right); }
+  static Block below(const Block block, const Block limit) { return vcltq_u8(block, limit); }
+  static uint64_t mask(const Block block) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(block), 4)), 0);
+  }
+};
+
+#include "StringCopyKernels.inc"
+
+}  // namespace neon
+#endif
+
+struct ImplementationList {
+  detail::memcpyCharReplaceImplementation entries[4];
+  std::size_t count = 0;
+};
+
+ImplementationList detectImplementations() {
+  ImplementationList list;
+#ifdef ATOMICRINGBUFFER_HAS_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    list.entries[list.count++] = {"avx2", avx2::memcpyCharReplaceVector, avx2::memcpyCharReplaceTableVector,
+                                  avx2::memcpyUntilVector};
+  }
+#endif
+#ifdef ATOMICRINGBUFFER_HAS_SSE2
+  list.entries[list.count++] = {"sse2", sse2::memcpyCharReplaceVector, sse2::memcpyCharReplaceTableVector,
+                                  sse2::memcpyUntilVector};
+#endif
+#ifdef ATOMICRINGBUFFER_HAS_NEON
+  list.entries[list.count++] = {"neon", neon::memcpyCharReplaceVector, neon::memcpyCharReplaceTableVector,
+                                  neon::memcpyUntilVector};
+#endif
+  list.entries[list.count++] = {"scalar", memcpyCharReplaceScalar, memcpyCharReplaceTableScalar, memcpyUntilScalar};
+  return list;
+}
+
+std::size_t memcpyUntil(char* dest, const char* src, const char stop, const std::size_t len) {
+  static const detail::memcpyUntilFunction implementation = []() {
+    std::size_t numImplementations = 0;
+    return detail::memcpyCharReplaceImplementations(numImplementations)[0].untilFunction;
+  }();
+  return implementation(dest, src, stop, len);
+}
+
+}  // namespace
+
+CharReplaceTable::CharReplaceTable() {
+  std::fill(std::begin(replacements_), std::end(replacements_), nullptr);
+  std::fill(std::begin(replacementLens_), std::end(replacementLens_), 0);
+}
+
+void CharReplaceTable::set(const char search, const char* const replace) {
+  const unsigned char idx = static_cast<unsigned char>(search);
+  replacements_[idx] = replace;
+  replacementLens_[idx] = (replace != nullptr ? static_cast<uint32_t>(strlen(replace)) : 0);
+  updateClassification();
+}
+
+void CharReplaceTable::updateClassification() {
+  numReplaced_ = static_cast<std::size_t>(
+      std::count_if(std::begin(replacements_), std::end(replacements_), [](const char* r) { return r != nullptr; }));
+  removesBytes_ = false;
+  for (std::size_t i = 0; i < 256; ++i) {
+    removesBytes_ |= (replacements_[i] != nullptr && replacementLens_[i] == 0);
+  }
+
+  std::size_t rangeEnd = 0;
+  while (rangeEnd < 255 && replacements_[rangeEnd] != nullptr) {
+    ++rangeEnd;
+  }
+  rangeEnd_ = static_cast<uint8_t>(rangeEnd);
+
+  std::size_t numSearch = 0;
+  for (std::size_t i = rangeEnd; i < 256; ++i) {
+    if (replacements_[i] == nullptr) {
+      continue;
+    }
+    if (numSearch == kMaxVectorSearch) {
+      vectorizable_ = false;
+      return;
+    }
+    vectorSearch_[numSearch++] = static_cast<char>(i);
+  }
+  vectorizable_ = true;
+
+  // Fill the remaining entries with a byte that is replaced anyways, so that they do not change the classification.
+  const char filler = (numSearch > 0) ? vectorSearch_[0] : '\0';
+  std::fill(std::next(vectorSearch_, numSearch), std::end(vectorSearch_), filler);
+}
+
+std::size_t CharReplaceEncoder::encodedLen(const char* src, const std::size_t srcLen,
+                                           const std::size_t maxLen) const {
+  std::size_t len = (pending_ != nullptr ? strlen(pending_) : 0);
+  if (table_.empty()) {
+    return std::min(len + srcLen, maxLen);
+  }
+  for (std::size_t i = 0; i < srcLen && len < maxLen; ++i) {
+    len += (table_.replacement(src[i]) != nullptr ? table_.replacementLen(src[i]) : 1);
+  }
+  return std::min(len, maxLen);
+}
+
+memcpyCharReplaceResult CharReplaceEncoder::encode(char* dest, const char* src, const std::size_t destLen,
+                                                   const std::size_t srcLen) {
+  memcpyCharReplaceResult result;
+  result.partialReplace = pending_;
+  if (dest == nullptr) {
+    return result;
+  }
+
+  char* const destEnd = std::next(dest, destLen);
+  if (pending_ != nullptr) {
+    const std::size_t pendingLen = strlen(pending_);
+    const std::size_t bytesToInsert = std::min(pendingLen, destLen);
+    memcpy(dest, pending_, bytesToInsert);
+    std::advance(dest, bytesToInsert);
+    pending_ = (bytesToInsert == pendingLen) ? nullptr : std::next(pending_, bytesToInsert);
+  }
+
+  if (pending_ == nullptr) {
+    result = memcpyCharReplace(dest, src, table_, std::distance(dest, destEnd), srcLen);
+    pending_ = result.partialReplace;
+  }
+  if (result.nextByte == nullptr) {
+    result.nextByte = dest;
+  }
+  result.partialReplace = pending_;
+  return result;
+}
+
+CharReplaceDecoder::CharReplaceDecoder(const CharReplaceTable& table) { build(table); }
+
+CharReplaceDecoder::CharReplaceDecoder(const char search, const char* const replace) {
+  CharReplaceTable table;
+  table.set(search, replace);
+  build(table);
+}
+
+void CharReplaceDecoder::build(const CharReplaceTable& table) {
+  // Collect all replacements that can be decoded.
+  bool haveLead = false;
+  Sequence candidates[256];
+  std::size_t numCandidates = 0;
+  for (std::size_t i = 0; i < 256; ++i) {
+    const char decoded = static_cast<char>(i);
+    const char* const chars = table.replacement(decoded);
+    const std::size_t len = table.replacementLen(decoded);
+    if (chars == nullptr || len == 0) {
+      continue;
+    }
+    if (!haveLead) {
+      lead_ = chars[0];
+      haveLead = true;
+    }
+    if (chars[0] != lead_ || len > kMaxSequenceLen) {
+      valid_ = false;
+      continue;
+    }
+    const Sequence sequence{chars, len, decoded};
+    const bool ambiguous = std::any_of(candidates, std::next(candidates, numCandidates), [&](const Sequence& other) {
+      return memcmp(other.chars, sequence.chars, std::min(other.len, sequence.len)) == 0;
+    });
+    if (ambiguous) {
+      valid_ = false;
+      continue;
+    }
+    candidates[numCandidates++] = sequence;
+  }
+
+  // Sort by the second byte, so that match() only compares sequences that can match.
+  std::fill(std::begin(bucketBegin_), std::end(bucketBegin_), 0);
+  for (std::size_t i = 0; i < numCandidates; ++i) {
+    if (candidates[i].len > 1) {
+      ++bucketBegin_[static_cast<unsigned char>(candidates[i].chars[1]) + 1];
+    }
+  }
+  const std::size_t numSingle =
+      std::count_if(candidates, std::next(candidates, numCandidates), [](const Sequence& s) { return s.len == 1; });
+  bucketBegin_[0] = static_cast<uint16_t>(numSingle);
+  for (std::size_t i = 1; i < 257; ++i) {
+    bucketBegin_[i] = static_cast<uint16_t>(bucketBegin_[i] + bucketBegin_[i - 1]);
+  }
+
+  uint16_t insertIdx[256];
+  std::copy(std::begin(bucketBegin_), std::prev(std::end(bucketBegin_)), std::begin(insertIdx));
+  std::size_t singleIdx = 0;
+  for (std::size_t i = 0; i < numCandidates; ++i) {
+    if (candidates[i].len == 1) {
+      sequences_[singleIdx++] = candidates[i];
+    } else {
+      sequences_[insertIdx[static_cast<unsigned char>(candidates[i].chars[1])]++] = candidates[i];
+    }
+  }
+  numSequences_ = numCandidates;
+}
+
+CharReplaceDecoder::Match CharReplaceDecoder::match(const char* src, const std::size_t srcLen) const {
+  if (bucketBegin_[0] != 0) {
+    // The lead byte alone is a replacement. As no replacement is a prefix of another one, it is the only one.
+    return Match{Match::Kind::kSequence, 1, sequences_[0].decoded};
+  }
+  if (numSequences_ == 0) {
+    return Match{Match::Kind::kLiteral, 1, src[0]};
+  }
+  if (srcLen < 2) {
+    return Match{Match::Kind::kIncomplete, 0, '\0'};
+  }
+
+  bool incomplete = false;
+  const unsigned char second = static_cast<unsigned char>(src[1]);
+  for (std::size_t i = bucketBegin_[second]; i < bucketBegin_[second + 1]; ++i) {
+    const Sequence& sequence = sequences_[i];
+    if (memcmp(sequence.chars, src, std::min(sequence.len, srcLen)) != 0) {
+      continue;
+    }
+    if (sequence.len <= srcLen) {
+      return Match{Match::Kind::kSequence, sequence.len, sequence.decoded};
+    }
+    incomplete = true;
+  }
+  return incomplete ? Match{Match::Kind::kIncomplete, 0, '\0'} : Match{Match::Kind::kLiteral, 1, src[0]};
+}
+
+memcpyCharReplaceResult CharReplaceDecoder::decode(char* dest, const char* src, const std::size_t destLen,
+                                                   const std::size_t srcLen) {
+  memcpyCharReplaceResult result;
+  if (dest == nullptr) {
+    return result;
+  }
+  if (src == nullptr) {
+    result.nextByte = dest;
+    return result;
+  }
+
+  const char* const srcBegin = src;
+  const char* const srcEnd = std::next(src, srcLen);
+  char* const destEnd = std::next(dest, destLen);
+
+  // Finish the replacement that began at the end of the previous input. Bytes from pending_ are consumed first.
+  while (pendingLen_ > 0 && dest < destEnd) {
+    char window[kMaxSequenceLen];
+    const std::size_t numTaken =
+        std::min(kMaxSequenceLen - pendingLen_, static_cast<std::size_t>(std::distance(src, srcEnd)));
+    memcpy(window, pending_, pendingLen_);
+    memcpy(std::next(window, pendingLen_), src, numTaken);
+
+    Match found{Match::Kind::kLiteral, 1, window[0]};
+    if (window[0] == lead_) {
+      found = match(window, pendingLen_ + numTaken);
+    }
+    if (found.kind == Match::Kind::kIncomplete) {
+      memcpy(std::next(pending_, pendingLen_), src, numTaken);
+      pendingLen_ += numTaken;
+      std::advance(src, numTaken);
+      break;
+    }
+
+    *dest = found.decoded;
+    std::advance(dest, 1);
+    if (found.len < pendingLen_) {
+      memmove(pending_, std::next(pending_, found.len), pendingLen_ - found.len);
+      pendingLen_ -= found.len;
+    } else {
+      std::advance(src, found.len - pendingLen_);
+      pendingLen_ = 0;
+    }
+  }
+
+  while (pendingLen_ == 0 && src < srcEnd && dest < destEnd) {
+    const std::size_t run = memcpyUntil(
+        dest, src, lead_, static_cast<std::size_t>(std::min(std::distance(src, srcEnd), std::distance(dest, destEnd))));
+    std::advance(src, run);
+    std::advance(dest, run);
+    if (src == srcEnd || dest == destEnd) {
+      break;
+    }
+
+    const Match found = match(src, static_cast<std::size_t>(std::distance(src, srcEnd)));
+    if (found.kind == Match::Kind::kIncomplete) {
+      pendingLen_ = static_cast<std::size_t>(std::distance(src, srcEnd));
+      memcpy(pending_, src, pendingLen_);
+      src = srcEnd;
+      break;
+    }
+    *dest = found.decoded;
+    std::advance(dest, 1);
+    std::advance(src, found.len);
+  }
+
+  result.len = static_cast<std::size_t>(std::distance(srcBegin, src));
+  result.nextByte = dest;
+  return result;
+}
+
+char* CharReplaceDecoder::finish(char* dest, const std::size_t destLen) {
+  const std::size_t numWritten = std::min(pendingLen_, destLen);
+  memcpy(dest, pending_, numWritten);
+  memmove(pending_, std::next(pending_, numWritten), pendingLen_ - numWritten);
+  pendingLen_ -= numWritten;
+  return std::next(dest, numWritten);
+}
+
+namespace detail {
+
+const memcpyCharReplaceImplementation* memcpyCharReplaceImplementations(std::size_t& numImplementations) {
+  static const ImplementationList list = detectImplementations();
+  numImplementations = list.count;
+  return list.entries;
+}
+
+}  // namespace detail
+
+memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const char search, const char* const replace,
+                                          const size_t destLen, const size_t srcLen) {
+  static const detail::memcpyCharReplaceFunction implementation = []() {
+    std::size_t numImplementations = 0;
+    return detail::memcpyCharReplaceImplementations(numImplementations)[0].function;
+  }();
+  return implementation(dest, src, search, replace, destLen, srcLen);
+}
+
+memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const CharReplaceTable& table,
+                                          const size_t destLen, const size_t srcLen) {
+  static const detail::memcpyCharReplaceTableFunction implementation = []() {
+    std::size_t numImplementations = 0;
+    return detail::memcpyCharReplaceImplementations(numImplementations)[0].tableFunction;
+  }();
+  return implementation(dest, src, table, destLen, srcLen);
+}
+
 }  // namespace AtomicRingBuffer
@@ -1,6 +1,7 @@
 #ifndef __ATOMICRINGBUFFER__STRINGCOPYHELPER_H__
 #define __ATOMICRINGBUFFER__STRINGCOPYHELPER_H__
 
+#include <cstdint>
 #include <cstring>
 
 namespace AtomicRingBuffer {
@@ -26,6 +27,8 @@ struct memcpyCharReplaceResult {
  * If dest runs out while inserting a copy of replace, replace is updated to point to the first character in replace
  * that was not copied into dest.
  *
+ * Scans 16 or 32 bytes at a time using SSE2, AVX2 or NEON where available. The instruction set is chosen at runtime.
+ *
  * \param dest Reference to pointer to the destination buffer. After the call, points to the byte after the last byte
  * that was written (which may be past the end of dest!)
  * \param src The (const!) char pointer to the bytes to read from.
@@ -42,6 +45,311 @@ struct memcpyCharReplaceResult {
 memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const char search,
                                           const char* const replace, const size_t destLen, const size_t srcLen);
 
+/**
+ * \brief Maps every byte value to the sequence that memcpyCharReplace() writes instead of it.
+ *
+ * Initially, every byte is copied unchanged. Replacement strings are not copied, so they must outlive the table.
+ *
+ * The vectorized implementations classify a block of bytes at once if the bytes to be replaced are a range starting at
+ * 0 (e.g. control characters) plus up to kMaxVectorSearch other bytes. This covers the escape sets of JSON, CSV or
+ * SLIP.
+ * Other tables are processed one byte at a time.
+ */
+class CharReplaceTable {
+ public:
+  constexpr static std::size_t kMaxVectorSearch = 4;
+
+  CharReplaceTable();
+
+  /**
+   * \brief Replace search with the null terminated string replace. An empty string removes search.
+   *
+   * \param replace If this is nullptr, search is copied unchanged again.
+   */
+  void set(const char search, const char* const replace);
+
+  /**
+   * \brief The replacement of c, or nullptr if c is copied unchanged.
+   */
+  const char* replacement(const char c) const { return replacements_[static_cast<unsigned char>(c)]; }
+
+  std::size_t replacementLen(const char c) const { return replacementLens_[static_cast<unsigned char>(c)]; }
+
+  /**
+   * \brief Whether any byte is replaced.
+   */
+  bool empty() const { return numReplaced_ == 0; }
+
+  /**
+   * \brief Whether any byte is replaced by an empty string.
+   */
+  bool removesBytes() const { return removesBytes_; }
+
+  /**
+   * \brief Whether the vectorized implementations can classify blocks of input. See vectorRangeEnd() and
+   * vectorSearch().
+   */
+  bool vectorizable() const { return vectorizable_; }
+
+  /**
+   * \brief All bytes below this value are replaced. Only valid if vectorizable().
+   */
+  uint8_t vectorRangeEnd() const { return rangeEnd_; }
+
+  /**
+   * \brief kMaxVectorSearch bytes that are replaced in addition to the range below vectorRangeEnd(). Entries may
+   * repeat. Only valid if vectorizable() and !empty().
+   */
+  const char* vectorSearch() const { return vectorSearch_; }
+
+ private:
+  void updateClassification();
+
+  const char* replacements_[256];
+  uint32_t replacementLens_[256];
+  std::size_t numReplaced_ = 0;
+  bool removesBytes_ = false;
+
+  bool vectorizable_ = true;
+  uint8_t rangeEnd_ = 0;
+  char vectorSearch_[kMaxVectorSearch] = {};
+};
+
+/**
+ * \brief Copy src to dest while replacing every byte with its replacement in table, in a single pass.
+ *
+ * Behaves like memcpyCharReplace() with a single search character: If dest runs out while inserting a replacement,
+ * partialReplace points to its first character that was not copied. Replacements are not replaced again.
+ *
+ * \returns The number of bytes that were consumed from src.
+ */
+memcpyCharReplaceResult memcpyCharReplace(char* dest, const char* src, const CharReplaceTable& table,
+                                          const size_t destLen, const size_t srcLen);
+
+/**
+ * \brief Resumable memcpyCharReplace() for writing a stream of data in chunks, e.g. into a ring buffer.
+ *
+ * If a replacement does not fit into the destination, the encoder remembers its remaining characters and writes them
+ * first on the next call. Thus, data can be encoded directly into consecutive buffer allocations of any size.
+ */
+class CharReplaceEncoder {
+ public:
+  explicit CharReplaceEncoder(const CharReplaceTable& table) : table_(table) {}
+  CharReplaceEncoder(const char search, const char* const replace) { table_.set(search, replace); }
+
+  const CharReplaceTable& table() const { return table_; }
+
+  /**
+   * \brief Whether part of a replacement still has to be written.
+   */
+  bool pending() const { return pending_ != nullptr; }
+
+  /**
+   * \brief The characters of a replacement that still have to be written, or nullptr.
+   */
+  const char* pendingReplace() const { return pending_; }
+
+  /**
+   * \brief Drop the pending replacement.
+   */
+  void reset() { pending_ = nullptr; }
+
+  /**
+   * \brief Number of bytes that encoding the pending replacement and src produces, but at most maxLen.
+   */
+  std::size_t encodedLen(const char* src, const std::size_t srcLen, const std::size_t maxLen) const;
+
+  /**
+   * \brief Write the pending replacement, then copy src while replacing characters, as memcpyCharReplace() does.
+   *
+   * \return result.len is the number of bytes consumed from src. result.nextByte points behind the last byte written
+   * and is only nullptr if dest is. result.partialReplace is the pending replacement after the call.
+   */
+  memcpyCharReplaceResult encode(char* dest, const char* src, const std::size_t destLen, const std::size_t srcLen);
+
+  /**
+   * \brief Encode src into a ring buffer, allocating and publishing as many chunks as needed or possible.
+   *
+   * Each allocation is made with partial_acceptable=true and requests no more than encodedLen() bytes, so every chunk
+   * is filled and published completely. Input that only consists of bytes with an empty replacement is consumed
+   * without allocating. A replacement may be split across chunks, so this encoder must be the only producer of
+   * buffer. Chunks of other producers would land in between and corrupt the escape sequences.
+   *
+   * If buffer rejects the publish of a chunk, e.g. because an earlier allocation has not been published yet, the chunk
+   * is returned with shrink() and does not count as consumed.
+   *
+   * \return The number of bytes consumed from src. If the buffer runs full, this is less than srcLen or a replacement
+   * is left pending. Call again with the remaining data, or with srcLen = 0 to only write the pending replacement.
+   */
+  template <typename RingBuffer>
+  std::size_t encodeInto(RingBuffer& buffer, const char* src, const std::size_t srcLen) {
+    std::size_t consumed = 0;
+    while (consumed < srcLen || pending()) {
+      const std::size_t needed = encodedLen(src + consumed, srcLen - consumed, buffer.capacity());
+      if (needed == 0 && buffer.capacity() != 0) {
+        // Everything left is removed by empty replacements.
+        consumed = srcLen;
+        break;
+      }
+      const auto mem = buffer.allocate(needed, true);
+      if (mem.len == 0) {
+        break;
+      }
+      const char* const pendingBefore = pending_;
+      const std::size_t len = encode(reinterpret_cast<char*>(mem.ptr), src + consumed, mem.len, srcLen - consumed).len;
+      if (buffer.publish(mem) != mem.len) {
+        pending_ = pendingBefore;
+        buffer.shrink(mem, 0);
+        break;
+      }
+      consumed += len;
+    }
+    return consumed;
+  }
+
+ private:
+  CharReplaceTable table_;
+  const char* pending_ = nullptr;
+};
+
+/**
+ * \brief Reverses the replacements of a CharReplaceTable, resumable across chunks of input such as the two ranges of
+ * data around the end of a ring buffer.
+ *
+ * All replacements must start with the same lead byte, no replacement may be a prefix of another and none may be
+ * longer than kMaxSequenceLen. Otherwise, valid() is false and the offending replacements are ignored. Bytes removed by
+ * an empty replacement cannot be restored. A lead byte that does not start a replacement is copied unchanged.
+ *
+ * The input is copied up to the next lead byte with vector instructions where available, see memcpyCharReplace().
+ */
+class CharReplaceDecoder {
+ public:
+  constexpr static std::size_t kMaxSequenceLen = 16;
+
+  explicit CharReplaceDecoder(const CharReplaceTable& table);
+  CharReplaceDecoder(const char search, const char* const replace);
+
+  /**
+   * \brief Whether all replacements of the table can be decoded unambiguously.
+   */
+  bool valid() const { return valid_; }
+
+  /**
+   * \brief Whether the end of the input seen so far may be the beginning of a replacement.
+   */
+  bool pending() const { return pendingLen_ != 0; }
+
+  /**
+   * \brief Drop the bytes of an incomplete replacement.
+   */
+  void reset() { pendingLen_ = 0; }
+
+  /**
+   * \brief Copy src to dest while turning replacements back into the original bytes.
+   *
+   * If src ends with the beginning of a replacement, these bytes are consumed and kept until the next call.
+   *
+   * \return result.len is the number of bytes consumed from src. result.nextByte points behind the last byte written
+   * and is only nullptr if dest is. result.partialReplace is not used.
+   */
+  memcpyCharReplaceResult decode(char* dest, const char* src, const std::size_t destLen, const std::size_t srcLen);
+
+  /**
+   * \brief At the end of the input, copy the bytes of an incomplete replacement unchanged.
+   *
+   * \return Points behind the last byte written.
+   */
+  char* finish(char* dest, const std::size_t destLen);
+
+  /**
+   * \brief Decode the data available in a ring buffer into dest, peeking and consuming as many ranges as needed.
+   *
+   * \return The number of bytes written to dest.
+   */
+  template <typename RingBuffer>
+  std::size_t decodeFrom(RingBuffer& buffer, char* dest, const std::size_t destLen) {
+    char* next = dest;
+    char* const destEnd = dest + destLen;
+    while (next < destEnd) {
+      auto data = buffer.peek(buffer.capacity(), true);
+      if (data.len == 0) {
+        break;
+      }
+      const auto result =
+          decode(next, reinterpret_cast<const char*>(data.ptr), static_cast<std::size_t>(destEnd - next), data.len);
+      next = result.nextByte;
+      const bool consumedAll = (result.len == data.len);
+      data.len = result.len;
+      if (data.len > 0) {
+        buffer.consume(data);
+      }
+      if (!consumedAll) {
+        break;
+      }
+    }
+    return static_cast<std::size_t>(next - dest);
+  }
+
+ private:
+  struct Sequence {
+    const char* chars;
+    std::size_t len;
+    char decoded;
+  };
+
+  struct Match {
+    enum class Kind { kSequence, kLiteral, kIncomplete };
+    Kind kind;
+    std::size_t len;
+    char decoded;
+  };
+
+  /**
+   * \brief Find the replacement at the beginning of src. src[0] is the lead byte.
+   */
+  Match match(const char* src, const std::size_t srcLen) const;
+
+  void build(const CharReplaceTable& table);
+
+  bool valid_ = true;
+  char lead_ = '\0';
+  // Sequences sorted by their second byte. A sequence of length 1 is stored in front of all others.
+  Sequence sequences_[256];
+  std::size_t numSequences_ = 0;
+  uint16_t bucketBegin_[257];
+
+  char pending_[kMaxSequenceLen];
+  std::size_t pendingLen_ = 0;
+};
+
+namespace detail {
+
+using memcpyCharReplaceFunction = memcpyCharReplaceResult (*)(char*, const char*, const char, const char* const,
+                                                              const size_t, const size_t);
+using memcpyCharReplaceTableFunction = memcpyCharReplaceResult (*)(char*, const char*, const CharReplaceTable&,
+                                                                   const size_t, const size_t);
+using memcpyUntilFunction = std::size_t (*)(char*, const char*, const char, const std::size_t);
+
+struct memcpyCharReplaceImplementation {
+  const char* name;
+  memcpyCharReplaceFunction function;
+  memcpyCharReplaceTableFunction tableFunction;
+  // Copies bytes until a given byte is found. Returns the number of bytes copied.
+  memcpyUntilFunction untilFunction;
+};
+
+/**
+ * \brief The implementations of memcpyCharReplace() and CharReplaceDecoder that the running CPU supports, from the
+ * fastest to the slowest.
+ *
+ * memcpyCharReplace() uses the first entry. The last entry is always the scalar implementation. Exposed for testing.
+ *
+ * \param numImplementations Set to the number of entries.
+ */
+const memcpyCharReplaceImplementation* memcpyCharReplaceImplementations(std::size_t& numImplementations);
+
+}  // namespace detail
+
 }  // namespace AtomicRingBuffer
 
 #endif  // __ATOMICRINGBUFFER__STRINGCOPYHELPER_H__
@@ -0,0 +1,175 @@
+#include "AtomicRingBuffer/Trace.h"
+
+// Requires std::mutex and thread_local. Compiles to nothing elsewhere, e.g. on microcontrollers, where buffers
+// cannot use EventTracing.
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+/**
+ * \brief The events of one thread. Written by that thread only, read while holding the registry mutex.
+ */
+struct ThreadTrace {
+  ThreadTrace(const std::size_t numEvents, const uint32_t id) : events(numEvents), threadId(id) {}
+
+  DynamicObjectRingBuffer<TraceEvent, std::allocator<TraceEvent>, SpscTraits> events;
+  const uint32_t threadId;
+
+  // Set when the thread has exited. The trace is freed once its events have been written or cleared.
+  std::atomic<bool> released{false};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadTrace>> threads;
+  std::size_t eventsPerThread = TraceLog::kDefaultEventsPerThread;
+  // Ids are not reused, so that the events of different threads never share a timeline.
+  uint32_t lastThreadId = 0;
+  std::atomic<uint64_t> numDropped{0};
+};
+
+Registry &registry() {
+  // Never destroyed, as threads may still record while static objects are destroyed.
+  static Registry *const instance = new Registry();
+  return *instance;
+}
+
+// The trace of the calling thread. Trivially destructible, so the fast path needs no initialization check.
+thread_local ThreadTrace *currentTrace = nullptr;
+
+/**
+ * \brief Releases the trace of its thread when the thread exits.
+ */
+struct ThreadTraceOwner {
+  ~ThreadTraceOwner() {
+    if (currentTrace != nullptr) {
+      currentTrace->released.store(true, std::memory_order_release);
+      currentTrace = nullptr;
+    }
+  }
+};
+
+ThreadTrace &threadTrace() {
+  if (currentTrace == nullptr) {
+    thread_local ThreadTraceOwner owner;
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.emplace_back(new ThreadTrace(reg.eventsPerThread, ++reg.lastThreadId));
+    currentTrace = reg.threads.back().get();
+  }
+  return *currentTrace;
+}
+
+/**
+ * \brief Free the traces of exited threads whose events have been consumed. Must be called with the registry mutex
+ * held.
+ */
+void eraseReleased(Registry &reg, const std::vector<ThreadTrace *> &drained) {
+  reg.threads.erase(std::remove_if(reg.threads.begin(), reg.threads.end(),
+                                   [&drained](const std::unique_ptr<ThreadTrace> &thread) {
+                                     return std::find(drained.begin(), drained.end(), thread.get()) != drained.end();
+                                   }),
+                    reg.threads.end());
+}
+
+const char *operationName(const detail::Operation op) {
+  switch (op) {
+    case detail::Operation::kAllocate:
+      return "allocate";
+    case detail::Operation::kPublish:
+      return "publish";
+    case detail::Operation::kPeek:
+      return "peek";
+    default:
+      return "consume";
+  }
+}
+
+uint64_t nowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+}  // namespace
+
+constexpr std::size_t TraceLog::kDefaultEventsPerThread;
+
+void TraceLog::record(const void *buffer, const detail::Operation op, const std::size_t index, const std::size_t len) {
+  if (!threadTrace().events.push(TraceEvent{buffer, nowNs(), index, len, op})) {
+    registry().numDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void TraceLog::setEventsPerThread(const std::size_t numEvents) {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.eventsPerThread = numEvents;
+}
+
+std::size_t TraceLog::writeChromeTrace(std::FILE *file) {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  std::size_t numWritten = 0;
+  std::vector<ThreadTrace *> drained;
+  std::fprintf(file, "{\"traceEvents\":[");
+  for (const std::unique_ptr<ThreadTrace> &thread : reg.threads) {
+    // Checking before draining makes all events of an exited thread visible.
+    if (thread->released.load(std::memory_order_acquire)) {
+      drained.push_back(thread.get());
+    }
+    TraceEvent event;
+    while (thread->events.pop(event)) {
+      // Timestamps are in microseconds.
+      std::fprintf(file,
+                   "%s\n{\"name\":\"%s\",\"cat\":\"AtomicRingBuffer\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,"
+                   "\"tid\":%u,\"args\":{\"buffer\":\"%p\",\"index\":%zu,\"len\":%zu}}",
+                   (numWritten == 0) ? "" : ",", operationName(event.op),
+                   static_cast<double>(event.timestampNs) / 1000.0, static_cast<unsigned>(thread->threadId),
+                   event.buffer, event.index, event.len);
+      ++numWritten;
+    }
+  }
+  std::fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+  eraseReleased(reg, drained);
+  return numWritten;
+}
+
+void TraceLog::clear() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<ThreadTrace *> drained;
+  for (const std::unique_ptr<ThreadTrace> &thread : reg.threads) {
+    if (thread->released.load(std::memory_order_acquire)) {
+      drained.push_back(thread.get());
+    }
+    while (thread->events.pop()) {
+    }
+  }
+  eraseReleased(reg, drained);
+  reg.numDropped.store(0, std::memory_order_relaxed);
+}
+
+std::size_t TraceLog::numThreadBuffers() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.threads.size();
+}
+
+uint64_t TraceLog::numDropped() { return registry().numDropped.load(std::memory_order_relaxed); }
+
+}  // namespace AtomicRingBuffer
+
+#endif  // defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
@@ -0,0 +1,120 @@
+#ifndef __ATOMICRINGBUFFER__TRACE_H__
+#define __ATOMICRINGBUFFER__TRACE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "Statistics.h"
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Tracing policy that records nothing. The hooks compile to nothing.
+ */
+struct NoTracing {
+  static constexpr bool kEnabled = false;
+};
+
+/**
+ * \brief Tracing policy that records every successful allocate, publish, peek and consume in the TraceLog.
+ */
+struct EventTracing {
+  static constexpr bool kEnabled = true;
+};
+
+/**
+ * \brief A recorded operation on a ring buffer.
+ */
+struct TraceEvent {
+  /// The BasicAtomicRingBuffer the operation was made on.
+  const void *buffer;
+
+  /// Nanoseconds of std::chrono::steady_clock.
+  uint64_t timestampNs;
+
+  /// Offset of the first byte of the range from the beginning of the buffer.
+  std::size_t index;
+
+  /// Number of bytes of the range.
+  std::size_t len;
+
+  detail::Operation op;
+};
+
+/**
+ * \brief Collects the events of all buffers that use EventTracing.
+ *
+ * Each thread records into its own trace buffer, an SPSC ring buffer that is created on the first event of the thread
+ * and outlives the thread, so recording takes no lock. When a trace buffer is full, further events of its thread are
+ * dropped until the log has been written. Writing the log consumes the events and frees the trace buffers of threads
+ * that have exited:
+ *
+ *     std::FILE *file = std::fopen("trace.json", "w");
+ *     TraceLog::writeChromeTrace(file);
+ *
+ * The output is in the JSON trace event format, which can be opened in chrome://tracing or Perfetto. Each event is
+ * shown as an instant event on the timeline of its thread, with buffer, index and length as arguments.
+ *
+ * Requires AtomicRingBuffer/Trace.cpp, which needs std::mutex and thread_local and is therefore only built on UNIX and
+ * Windows. Events recorded from destructors of thread_local objects may be lost.
+ */
+class TraceLog {
+ public:
+  constexpr static std::size_t kDefaultEventsPerThread = 16384;
+
+  /**
+   * \brief Record an event in the trace buffer of the calling thread.
+   */
+  static void record(const void *buffer, detail::Operation op, std::size_t index, std::size_t len);
+
+  /**
+   * \brief Capacity of the trace buffers of threads that record their first event after this call.
+   */
+  static void setEventsPerThread(std::size_t numEvents);
+
+  /**
+   * \brief Write all recorded events as JSON trace events and remove them from the trace buffers.
+   *
+   * \return The number of events written.
+   */
+  static std::size_t writeChromeTrace(std::FILE *file);
+
+  /**
+   * \brief Remove all recorded events without writing them.
+   */
+  static void clear();
+
+  /**
+   * \brief Number of events dropped because a trace buffer was full.
+   */
+  static uint64_t numDropped();
+
+  /**
+   * \brief Number of trace buffers, including those of exited threads whose events have not been written yet.
+   */
+  static std::size_t numThreadBuffers();
+};
+
+namespace detail {
+
+/**
+ * \brief Forwards events to the TraceLog. The disabled variant does nothing and does not require Trace.cpp.
+ */
+template <bool kEnabled>
+struct Tracer {
+  static void record(const void *, Operation, std::size_t, std::size_t) {}
+};
+
+template <>
+struct Tracer<true> {
+  static void record(const void *buffer, const Operation op, const std::size_t index, const std::size_t len) {
+    TraceLog::record(buffer, op, index, len);
+  }
+};
+
+}  // namespace detail
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__TRACE_H__
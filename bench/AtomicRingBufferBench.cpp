@@ -0,0 +1,234 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/MirroredMemory.h"
+#include "AtomicRingBuffer/StaticAtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+constexpr std::size_t kSpscBufferSize = 4096;
+constexpr std::size_t kMaxBufferSize = 65536;
+
+template <typename BufferT>
+struct SpscFixture {
+  static BufferT ringBuffer;
+  static uint8_t storage[kMaxBufferSize];
+};
+
+template <typename BufferT>
+BufferT SpscFixture<BufferT>::ringBuffer;
+
+template <typename BufferT>
+uint8_t SpscFixture<BufferT>::storage[kMaxBufferSize];
+
+/*
+ * Thread 0 produces, thread 1 consumes. Both threads run the same number of iterations and move the same amount of
+ * data per iteration, so the buffer is empty again after each run.
+ *
+ * Arguments: message size, buffer capacity.
+ */
+template <typename BufferT>
+void BM_SpscThroughput(benchmark::State& state) {
+  using Fixture = SpscFixture<BufferT>;
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+  const std::size_t capacity = static_cast<std::size_t>(state.range(1));
+  std::vector<uint8_t> message(messageSize, 0xA5);
+
+  if (state.thread_index() == 0) {
+    Fixture::ringBuffer.init(Fixture::storage, capacity);
+  }
+
+  for (auto _ : state) {
+    std::size_t remaining = messageSize;
+    if (state.thread_index() == 0) {
+      while (remaining > 0) {
+        auto mem = Fixture::ringBuffer.allocate(remaining, true);
+        if (mem.len > 0) {
+          memcpy(mem.ptr, &message[messageSize - remaining], mem.len);
+          remaining -= Fixture::ringBuffer.publish(mem);
+        }
+      }
+    } else {
+      while (remaining > 0) {
+        auto mem = Fixture::ringBuffer.peek(remaining, true);
+        if (mem.len > 0) {
+          memcpy(&message[messageSize - remaining], mem.ptr, mem.len);
+          remaining -= Fixture::ringBuffer.consume(mem);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(message.data());
+  }
+
+  if (state.thread_index() == 0) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageSize));
+  }
+}
+
+template <typename BufferT>
+void runSingleThreadCycle(benchmark::State& state, BufferT& ringBuffer) {
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    auto mem = ringBuffer.allocate(messageSize, true);
+    benchmark::DoNotOptimize(ringBuffer.publish(mem));
+    auto peeked = ringBuffer.peek(messageSize, true);
+    benchmark::DoNotOptimize(ringBuffer.consume(peeked));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageSize));
+}
+
+/*
+ * Cost of one allocate/publish/peek/consume round-trip without contention.
+ */
+template <typename BufferT>
+void BM_SingleThreadCycle(benchmark::State& state) {
+  static uint8_t storage[kSpscBufferSize];
+  BufferT ringBuffer;
+  ringBuffer.init(storage, kSpscBufferSize);
+  runSingleThreadCycle(state, ringBuffer);
+}
+
+void BM_SingleThreadCycle_Static(benchmark::State& state) {
+  static StaticAtomicRingBuffer<kSpscBufferSize> ringBuffer;
+  runSingleThreadCycle(state, ringBuffer);
+}
+
+/*
+ * Fill the buffer with messages, then drain it. Unlike the round-trip, the indices are far apart, so producer and
+ * consumer work on different parts of the buffer.
+ */
+template <typename BufferT>
+void BM_SingleThreadFillDrain(benchmark::State& state) {
+  static uint8_t storage[kSpscBufferSize];
+  BufferT ringBuffer;
+  ringBuffer.init(storage, kSpscBufferSize);
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+  // The message size must divide the capacity, so that no message needs to wrap around.
+  const std::size_t numMessages = kSpscBufferSize / messageSize;
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < numMessages; ++i) {
+      benchmark::DoNotOptimize(ringBuffer.publish(ringBuffer.allocate(messageSize, false)));
+    }
+    for (std::size_t i = 0; i < numMessages; ++i) {
+      benchmark::DoNotOptimize(ringBuffer.consume(ringBuffer.peek(messageSize, false)));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numMessages));
+}
+
+/*
+ * Messages whose size does not divide the capacity, so that every few messages cross the end of the buffer. The split
+ * variant handles the wrap-around with a second allocate and peek, the other variants in a single call.
+ *
+ * Arguments: message size.
+ */
+constexpr std::size_t kWraparoundBufferSize = 1000;
+
+void BM_Wraparound_Split(benchmark::State& state) {
+  static uint8_t storage[kWraparoundBufferSize];
+  AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, kWraparoundBufferSize);
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+  std::vector<uint8_t> message(messageSize, 0x5A);
+
+  for (auto _ : state) {
+    for (std::size_t written = 0; written < messageSize;) {
+      auto mem = ringBuffer.allocate(messageSize - written, true);
+      memcpy(mem.ptr, &message[written], mem.len);
+      written += ringBuffer.publish(mem);
+    }
+    for (std::size_t read = 0; read < messageSize;) {
+      auto mem = ringBuffer.peek(messageSize - read, true);
+      memcpy(&message[read], mem.ptr, mem.len);
+      read += ringBuffer.consume(mem);
+    }
+    benchmark::DoNotOptimize(message.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageSize));
+}
+
+void BM_Wraparound_Segments(benchmark::State& state) {
+  static uint8_t storage[kWraparoundBufferSize];
+  AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, kWraparoundBufferSize);
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+  std::vector<uint8_t> message(messageSize, 0x5A);
+
+  for (auto _ : state) {
+    auto mem = ringBuffer.allocateSegments(messageSize, false);
+    memcpy(mem.first.ptr, message.data(), mem.first.len);
+    memcpy(mem.second.ptr, &message[mem.first.len], mem.second.len);
+    ringBuffer.publish(mem);
+
+    auto data = ringBuffer.peekSegments(messageSize, false);
+    memcpy(message.data(), data.first.ptr, data.first.len);
+    memcpy(&message[data.first.len], data.second.ptr, data.second.len);
+    ringBuffer.consume(data);
+    benchmark::DoNotOptimize(message.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageSize));
+}
+
+// The capacity is rounded up to the page size, so messages wrap around less often than in the other variants.
+void BM_Wraparound_Mirrored(benchmark::State& state) {
+  MirroredMemory memory;
+  if (!memory.map(kWraparoundBufferSize)) {
+    state.SkipWithError("Mirrored memory is not available.");
+    return;
+  }
+  MirroredAtomicRingBuffer ringBuffer;
+  ringBuffer.init(memory.data(), memory.size());
+  const std::size_t messageSize = static_cast<std::size_t>(state.range(0));
+  std::vector<uint8_t> message(messageSize, 0x5A);
+
+  for (auto _ : state) {
+    auto mem = ringBuffer.allocate(messageSize, false);
+    memcpy(mem.ptr, message.data(), mem.len);
+    ringBuffer.publish(mem);
+
+    auto data = ringBuffer.peek(messageSize, false);
+    memcpy(message.data(), data.ptr, data.len);
+    ringBuffer.consume(data);
+    benchmark::DoNotOptimize(message.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageSize));
+}
+
+void spscArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Threads(2)->UseRealTime()->ArgNames({"msg", "capacity"});
+  for (const int64_t capacity : {256, 4096, 65536}) {
+    for (const int64_t messageSize : {8, 64, 512}) {
+      if (messageSize < capacity) {
+        benchmark->Args({messageSize, capacity});
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_SingleThreadCycle, AtomicRingBuffer)->Arg(8)->Arg(100);
+BENCHMARK_TEMPLATE(BM_SingleThreadCycle, SpscAtomicRingBuffer)->Arg(8)->Arg(100);
+BENCHMARK(BM_SingleThreadCycle_Static)->Arg(8)->Arg(100);
+BENCHMARK_TEMPLATE(BM_SingleThreadFillDrain, AtomicRingBuffer)->Arg(8)->Arg(128);
+BENCHMARK_TEMPLATE(BM_SingleThreadFillDrain, SpscAtomicRingBuffer)->Arg(8)->Arg(128);
+
+BENCHMARK(BM_Wraparound_Split)->Arg(7)->Arg(333);
+BENCHMARK(BM_Wraparound_Segments)->Arg(7)->Arg(333);
+BENCHMARK(BM_Wraparound_Mirrored)->Arg(7)->Arg(333);
+
+BENCHMARK_TEMPLATE(BM_SpscThroughput, AtomicRingBuffer)->Apply(spscArguments);
+BENCHMARK_TEMPLATE(BM_SpscThroughput, CacheAlignedAtomicRingBuffer)->Apply(spscArguments);
+BENCHMARK_TEMPLATE(BM_SpscThroughput, SpscAtomicRingBuffer)->Apply(spscArguments);
+BENCHMARK_TEMPLATE(BM_SpscThroughput, CachedIndexAtomicRingBuffer)->Apply(spscArguments);
+
+}  // namespace AtomicRingBuffer
+
+BENCHMARK_MAIN();
@@ -0,0 +1,301 @@
+/*
+ * Round-trip latency between two threads that ping-pong a small message through two ring buffers.
+ *
+ * The initiator writes its timestamp into the ping buffer. The responder peeks it and echoes it through the pong
+ * buffer. Once the initiator peeks the echo, it records the elapsed time. Both threads can be pinned to cores. The
+ * first tenth of the iterations warms up caches and branch predictors and is not recorded.
+ *
+ * Usage: AtomicRingBufferLatency [--initiator-cpu N] [--responder-cpu N] [--iterations N] [--clock steady|tsc]
+ *                                [--histogram]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ATOMICRINGBUFFER_HAS_TSC 1
+#endif
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/BlockingRingBuffer.h"
+#include "LatencyHistogram.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+struct Config {
+  int initiatorCpu = -1;
+  int responderCpu = -1;
+  uint64_t iterations = 200000;
+  bool useTsc = false;
+  bool printHistogram = false;
+};
+
+/**
+ * \brief Pin the calling thread to a core. Pinning is only supported on Linux. A negative cpu leaves the thread unpinned.
+ */
+void pinToCpu(const int cpu) {
+  if (cpu < 0) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0) {
+    return;
+  }
+#endif
+  std::fprintf(stderr, "Could not pin thread to CPU %d. Running unpinned.\n", cpu);
+}
+
+/**
+ * \brief Reads either std::chrono::steady_clock or the time stamp counter and converts ticks to nanoseconds.
+ */
+class Clock {
+ public:
+  explicit Clock(const bool useTsc) : useTsc_(useTsc) {
+#ifdef ATOMICRINGBUFFER_HAS_TSC
+    if (useTsc_) {
+      calibrate();
+    }
+#else
+    useTsc_ = false;
+#endif
+  }
+
+  bool usesTsc() const { return useTsc_; }
+
+  uint64_t now() const {
+#ifdef ATOMICRINGBUFFER_HAS_TSC
+    if (useTsc_) {
+      return __rdtsc();
+    }
+#endif
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  }
+
+  /// Ticks per nanosecond.
+  double ticksPerNs() const { return ticksPerNs_; }
+
+ private:
+  void calibrate() {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startTicks = now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const uint64_t endTicks = now();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    ticksPerNs_ = static_cast<double>(endTicks - startTicks) /
+                  static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  bool useTsc_;
+  double ticksPerNs_ = static_cast<double>(std::chrono::steady_clock::period::den) /
+                       static_cast<double>(std::chrono::steady_clock::period::num) / 1e9;
+};
+
+/**
+ * \brief Retry immediately.
+ */
+struct SpinWait {
+  static constexpr const char *kName = "spin";
+
+  template <typename BufferT>
+  using Buffer = BufferT;
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange allocate(BufferT &buffer, const std::size_t len) {
+    typename BufferT::MemoryRange mem;
+    while ((mem = buffer.allocate(len, false)).len == 0) {
+    }
+    return mem;
+  }
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange peek(BufferT &buffer, const std::size_t len) {
+    typename BufferT::MemoryRange mem;
+    while ((mem = buffer.peek(len, false)).len == 0) {
+    }
+    return mem;
+  }
+};
+
+/**
+ * \brief Yield to other threads between retries.
+ */
+struct YieldWait {
+  static constexpr const char *kName = "yield";
+
+  template <typename BufferT>
+  using Buffer = BufferT;
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange allocate(BufferT &buffer, const std::size_t len) {
+    typename BufferT::MemoryRange mem;
+    while ((mem = buffer.allocate(len, false)).len == 0) {
+      std::this_thread::yield();
+    }
+    return mem;
+  }
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange peek(BufferT &buffer, const std::size_t len) {
+    typename BufferT::MemoryRange mem;
+    while ((mem = buffer.peek(len, false)).len == 0) {
+      std::this_thread::yield();
+    }
+    return mem;
+  }
+};
+
+/**
+ * \brief Spin briefly, then sleep until the other side publishes. See BlockingRingBuffer.
+ */
+struct BlockingWait {
+  static constexpr const char *kName = "block";
+
+  template <typename BufferT>
+  using Buffer = BlockingRingBuffer<BufferT>;
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange allocate(BufferT &buffer, const std::size_t len) {
+    return buffer.allocateWait(len, false);
+  }
+
+  template <typename BufferT>
+  static typename BufferT::MemoryRange peek(BufferT &buffer, const std::size_t len) {
+    return buffer.peekWait(len, false);
+  }
+};
+
+template <typename Wait, typename BufferT>
+void send(BufferT &buffer, const uint64_t value) {
+  auto mem = Wait::allocate(buffer, sizeof(value));
+  memcpy(mem.ptr, &value, sizeof(value));
+  buffer.publish(mem);
+}
+
+template <typename Wait, typename BufferT>
+uint64_t receive(BufferT &buffer) {
+  uint64_t value = 0;
+  auto mem = Wait::peek(buffer, sizeof(value));
+  memcpy(&value, mem.ptr, sizeof(value));
+  buffer.consume(mem);
+  return value;
+}
+
+template <typename BufferT, typename Wait>
+void runPingPong(const char *bufferName, const std::size_t bufferSize, const Config &config, const Clock &clock) {
+  using Buffer = typename Wait::template Buffer<BufferT>;
+
+  std::vector<uint8_t> pingStorage(bufferSize);
+  std::vector<uint8_t> pongStorage(bufferSize);
+  // On the stack, as operator new does not respect the alignment of CacheAlignedTraits before C++17.
+  Buffer ping;
+  Buffer pong;
+  ping.init(pingStorage.data(), bufferSize);
+  pong.init(pongStorage.data(), bufferSize);
+
+  const uint64_t warmupIterations = config.iterations / 10;
+  const uint64_t totalIterations = warmupIterations + config.iterations;
+
+  std::thread responder([&]() {
+    pinToCpu(config.responderCpu);
+    for (uint64_t i = 0; i < totalIterations; ++i) {
+      send<Wait>(pong, receive<Wait>(ping));
+    }
+  });
+
+  LatencyHistogram histogram;
+  pinToCpu(config.initiatorCpu);
+  for (uint64_t i = 0; i < totalIterations; ++i) {
+    send<Wait>(ping, clock.now());
+    const uint64_t elapsed = clock.now() - receive<Wait>(pong);
+    if (i >= warmupIterations) {
+      histogram.record(elapsed);
+    }
+  }
+  responder.join();
+
+  const double ticksPerNs = clock.ticksPerNs();
+  std::printf("%-14s %-6s %8zu %10.0f %10.0f %10.0f %10.0f\n", bufferName, Wait::kName, bufferSize,
+              static_cast<double>(histogram.percentile(50.0)) / ticksPerNs,
+              static_cast<double>(histogram.percentile(99.0)) / ticksPerNs,
+              static_cast<double>(histogram.percentile(99.9)) / ticksPerNs,
+              static_cast<double>(histogram.max()) / ticksPerNs);
+  if (config.printHistogram) {
+    histogram.printPercentileDistribution(stdout, ticksPerNs);
+    std::printf("\n");
+  }
+}
+
+template <typename BufferT>
+void runWaitStrategies(const char *bufferName, const Config &config, const Clock &clock) {
+  for (const std::size_t bufferSize : {64, 4096}) {
+    runPingPong<BufferT, SpinWait>(bufferName, bufferSize, config, clock);
+    runPingPong<BufferT, YieldWait>(bufferName, bufferSize, config, clock);
+    runPingPong<BufferT, BlockingWait>(bufferName, bufferSize, config, clock);
+  }
+}
+
+bool parseArguments(int argc, char **argv, Config &config) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = (i + 1 < argc);
+    if (arg == "--initiator-cpu" && hasValue) {
+      config.initiatorCpu = std::atoi(argv[++i]);
+    } else if (arg == "--responder-cpu" && hasValue) {
+      config.responderCpu = std::atoi(argv[++i]);
+    } else if (arg == "--iterations" && hasValue) {
+      config.iterations = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--clock" && hasValue) {
+      config.useTsc = (std::string(argv[++i]) == "tsc");
+    } else if (arg == "--histogram") {
+      config.printHistogram = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+}  // namespace AtomicRingBuffer
+
+int main(int argc, char **argv) {
+  using namespace AtomicRingBuffer;
+
+  Config config;
+  if (!parseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "Usage: %s [--initiator-cpu N] [--responder-cpu N] [--iterations N] [--clock steady|tsc] "
+                 "[--histogram]\n",
+                 argv[0]);
+    return EXIT_FAILURE;
+  }
+  const Clock clock(config.useTsc);
+  std::printf("Round-trip latency in ns over %llu iterations, clock: %s\n",
+              static_cast<unsigned long long>(config.iterations), clock.usesTsc() ? "tsc" : "steady_clock");
+  std::printf("%-14s %-6s %8s %10s %10s %10s %10s\n", "buffer", "wait", "capacity", "p50", "p99", "p99.9", "max");
+
+  runWaitStrategies<AtomicRingBuffer::AtomicRingBuffer>("default", config, clock);
+  runWaitStrategies<SpscAtomicRingBuffer>("spsc", config, clock);
+  runWaitStrategies<CachedIndexAtomicRingBuffer>("cachedIndex", config, clock);
+  runWaitStrategies<CacheAlignedAtomicRingBuffer>("cacheAligned", config, clock);
+
+  return EXIT_SUCCESS;
+}
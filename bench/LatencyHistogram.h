@@ -0,0 +1,112 @@
+#ifndef __ATOMICRINGBUFFER__BENCH__LATENCYHISTOGRAM_H__
+#define __ATOMICRINGBUFFER__BENCH__LATENCYHISTOGRAM_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace AtomicRingBuffer {
+
+/**
+ * \brief Histogram of latencies with a bounded relative error, following the bucket layout of HdrHistogram.
+ *
+ * Values below kSubBucketCount are counted exactly. Above, every power of two is split into kSubBucketCount / 2 linear
+ * sub-buckets, so each recorded value is off by less than 2 / kSubBucketCount (about 1.6%). Recording is a few shifts
+ * and an increment, so it does not distort the measurement.
+ */
+class LatencyHistogram {
+ public:
+  constexpr static uint32_t kSubBucketBits = 7;
+  constexpr static uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+
+  LatencyHistogram() : counts_((64 - kSubBucketBits + 1) * kSubBucketCount / 2 + kSubBucketCount / 2, 0) {}
+
+  void record(const uint64_t value) {
+    ++counts_[bucketIndex(value)];
+    ++totalCount_;
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  uint64_t count() const { return totalCount_; }
+
+  uint64_t max() const { return max_; }
+
+  /**
+   * \brief Smallest recorded value such that percentile percent of all values are less or equal. Reports the upper
+   * end of the bucket, but never more than max().
+   */
+  uint64_t percentile(const double percentile) const {
+    if (totalCount_ == 0) {
+      return 0;
+    }
+    uint64_t threshold = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(totalCount_) + 0.5);
+    threshold = (threshold == 0) ? 1 : threshold;
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      seen += counts_[i];
+      if (seen >= threshold) {
+        const uint64_t upper = bucketUpperValue(i);
+        return (upper < max_) ? upper : max_;
+      }
+    }
+    return max_;
+  }
+
+  /**
+   * \brief Print the distribution in the percentile format of HdrHistogram, scaling values by 1 / unitDivisor.
+   */
+  void printPercentileDistribution(std::FILE *out, const double unitDivisor) const {
+    std::fprintf(out, "%12s %14s %10s %14s\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      if (counts_[i] == 0) {
+        continue;
+      }
+      seen += counts_[i];
+      const double fraction = static_cast<double>(seen) / static_cast<double>(totalCount_);
+      const double upper = static_cast<double>(bucketUpperValue(i)) / unitDivisor;
+      if (seen < totalCount_) {
+        std::fprintf(out, "%12.3f %14.12f %10llu %14.2f\n", upper, fraction, static_cast<unsigned long long>(seen),
+                     1.0 / (1.0 - fraction));
+      } else {
+        std::fprintf(out, "%12.3f %14.12f %10llu %14s\n", upper, fraction, static_cast<unsigned long long>(seen), "inf");
+      }
+    }
+  }
+
+ private:
+  static std::size_t bucketIndex(const uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<std::size_t>(value);
+    }
+    // Position of the highest set bit, at least kSubBucketBits.
+    uint32_t magnitude = kSubBucketBits;
+    while ((value >> magnitude) >= 2) {
+      ++magnitude;
+    }
+    // Keep the kSubBucketBits - 1 bits following the highest bit.
+    const uint64_t subBucket = (value >> (magnitude - kSubBucketBits + 1)) - kSubBucketCount / 2;
+    return static_cast<std::size_t>(kSubBucketCount + (magnitude - kSubBucketBits) * (kSubBucketCount / 2) + subBucket);
+  }
+
+  static uint64_t bucketUpperValue(const std::size_t index) {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+    const uint64_t magnitude = (index - kSubBucketCount) / (kSubBucketCount / 2) + kSubBucketBits;
+    const uint64_t subBucket = (index - kSubBucketCount) % (kSubBucketCount / 2) + kSubBucketCount / 2;
+    const uint32_t shift = static_cast<uint32_t>(magnitude - kSubBucketBits + 1);
+    return ((subBucket + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t totalCount_ = 0;
+  uint64_t max_ = 0;
+};
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __ATOMICRINGBUFFER__BENCH__LATENCYHISTOGRAM_H__
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#include "AtomicRingBuffer/MpmcObjectRingBuffer.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+constexpr uint16_t kObjectCapacity = 256;
+
+struct SmallObject {
+  uint32_t value;
+};
+
+struct LargeObject {
+  std::array<uint64_t, 32> values;
+};
+
+template <typename T>
+void fill(T& object, const uint64_t value) {
+  object.value = static_cast<uint32_t>(value);
+}
+
+void fill(LargeObject& object, const uint64_t value) { object.values.fill(value); }
+
+/*
+ * Cost of one allocate/publish/peek/consume round-trip of a single object without contention.
+ */
+template <typename T>
+void BM_ObjectSingleThreadCycle(benchmark::State& state) {
+  static ObjectRingBuffer<T, kObjectCapacity> ringBuffer;
+  uint64_t counter = 0;
+
+  for (auto _ : state) {
+    auto mem = ringBuffer.allocate();
+    fill(*mem.ptr, ++counter);
+    ringBuffer.publish(mem);
+    auto peeked = ringBuffer.peek();
+    benchmark::DoNotOptimize(*peeked.ptr);
+    ringBuffer.consume(peeked);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(T)));
+}
+
+/*
+ * Like BM_ObjectSingleThreadCycle, but moves state.range(0) objects per call.
+ */
+template <typename T>
+void BM_ObjectSingleThreadBatch(benchmark::State& state) {
+  static ObjectRingBuffer<T, kObjectCapacity> ringBuffer;
+  const std::size_t batchSize = static_cast<std::size_t>(state.range(0));
+  uint64_t counter = 0;
+
+  for (auto _ : state) {
+    auto mem = ringBuffer.allocateSegments(batchSize);
+    for (std::size_t i = 0; i < mem.first.len; ++i) {
+      fill(mem.first.ptr[i], ++counter);
+    }
+    for (std::size_t i = 0; i < mem.second.len; ++i) {
+      fill(mem.second.ptr[i], ++counter);
+    }
+    ringBuffer.publish(mem);
+    auto peeked = ringBuffer.peekSegments(batchSize);
+    benchmark::DoNotOptimize(peeked.first.ptr);
+    ringBuffer.consume(peeked);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batchSize));
+}
+
+template <typename BufferT>
+struct ObjectSpscFixture {
+  static BufferT ringBuffer;
+};
+
+template <typename BufferT>
+BufferT ObjectSpscFixture<BufferT>::ringBuffer;
+
+/*
+ * Thread 0 produces, thread 1 consumes one object per iteration.
+ */
+template <typename BufferT>
+void BM_ObjectSpscThroughput(benchmark::State& state) {
+  auto& ringBuffer = ObjectSpscFixture<BufferT>::ringBuffer;
+  typename BufferT::value_type object{};
+
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      typename BufferT::MemoryRange mem;
+      while ((mem = ringBuffer.allocate()).len == 0) {
+      }
+      *mem.ptr = object;
+      ringBuffer.publish(mem);
+    } else {
+      typename BufferT::MemoryRange mem;
+      while ((mem = ringBuffer.peek()).len == 0) {
+      }
+      object = *mem.ptr;
+      ringBuffer.consume(mem);
+    }
+    benchmark::DoNotOptimize(object);
+  }
+
+  if (state.thread_index() == 0) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ObjectSingleThreadCycle, SmallObject);
+BENCHMARK_TEMPLATE(BM_ObjectSingleThreadCycle, LargeObject);
+
+BENCHMARK_TEMPLATE(BM_ObjectSingleThreadBatch, SmallObject)->Arg(8)->Arg(100);
+BENCHMARK_TEMPLATE(BM_ObjectSingleThreadBatch, LargeObject)->Arg(8)->Arg(100);
+
+BENCHMARK_TEMPLATE(BM_ObjectSpscThroughput, ObjectRingBuffer<SmallObject, kObjectCapacity>)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ObjectSpscThroughput, ObjectRingBuffer<LargeObject, kObjectCapacity>)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ObjectSpscThroughput, MpmcObjectRingBuffer<SmallObject, kObjectCapacity>)
+    ->Threads(2)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ObjectSpscThroughput, MpmcObjectRingBuffer<LargeObject, kObjectCapacity>)
+    ->Threads(2)
+    ->UseRealTime();
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "AtomicRingBuffer/StringCopyHelper.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+constexpr std::size_t kSourceSize = 4096;
+
+/*
+ * Copy kSourceSize bytes, of which every state.range(0)-th byte is replaced by two bytes. A distance of 0 means that
+ * the source contains no match at all.
+ */
+void BM_memcpyCharReplace(benchmark::State& state) {
+  const std::size_t matchDistance = static_cast<std::size_t>(state.range(0));
+  std::vector<char> src(kSourceSize, 'a');
+  if (matchDistance > 0) {
+    for (std::size_t i = matchDistance - 1; i < kSourceSize; i += matchDistance) {
+      src[i] = '\n';
+    }
+  }
+  std::vector<char> dest(2 * kSourceSize);
+
+  for (auto _ : state) {
+    auto result = memcpyCharReplace(dest.data(), src.data(), '\n', "\r\n", dest.size(), src.size());
+    benchmark::DoNotOptimize(result);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kSourceSize));
+}
+
+/*
+ * Escape kSourceSize bytes for a JSON string in one pass, with every state.range(0)-th byte being a quote.
+ */
+void BM_memcpyCharReplaceTable(benchmark::State& state) {
+  const std::size_t matchDistance = static_cast<std::size_t>(state.range(0));
+  std::vector<char> src(kSourceSize, 'a');
+  if (matchDistance > 0) {
+    for (std::size_t i = matchDistance - 1; i < kSourceSize; i += matchDistance) {
+      src[i] = '"';
+    }
+  }
+  std::vector<char> dest(2 * kSourceSize);
+
+  CharReplaceTable table;
+  for (char c = 0; c < 0x20; ++c) {
+    table.set(c, "\\u00XX");
+  }
+  table.set('"', "\\\"");
+  table.set('\\', "\\\\");
+
+  for (auto _ : state) {
+    auto result = memcpyCharReplace(dest.data(), src.data(), table, dest.size(), src.size());
+    benchmark::DoNotOptimize(result);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kSourceSize));
+}
+
+/*
+ * Plain memcpy() of the same amount of data as a baseline.
+ */
+void BM_memcpy(benchmark::State& state) {
+  std::vector<char> src(kSourceSize, 'a');
+  std::vector<char> dest(kSourceSize);
+
+  for (auto _ : state) {
+    memcpy(dest.data(), src.data(), kSourceSize);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kSourceSize));
+}
+
+}  // namespace
+
+BENCHMARK(BM_memcpyCharReplace)->ArgName("matchDistance")->Arg(0)->Arg(1000)->Arg(100)->Arg(10)->Arg(2);
+BENCHMARK(BM_memcpyCharReplaceTable)->ArgName("matchDistance")->Arg(0)->Arg(1000)->Arg(100)->Arg(10)->Arg(2);
+BENCHMARK(BM_memcpy);
+
+}  // namespace AtomicRingBuffer
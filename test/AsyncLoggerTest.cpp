@@ -0,0 +1,235 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AtomicRingBuffer/AsyncLogger.h"
+
+namespace AtomicRingBuffer {
+
+class AsyncLoggerFixture : public ::testing::Test {
+ public:
+  void SetUp() { file = std::tmpfile(); }
+
+  void TearDown() { std::fclose(file); }
+
+  int fd() const { return fileno(file); }
+
+  std::string contents() const {
+    std::string text;
+    char chunk[4096];
+    off_t offset = 0;
+    ssize_t len;
+    while ((len = pread(fd(), chunk, sizeof(chunk), offset)) > 0) {
+      text.append(chunk, static_cast<std::size_t>(len));
+      offset += len;
+    }
+    return text;
+  }
+
+  std::FILE *file = nullptr;
+};
+
+TEST_F(AsyncLoggerFixture, FormatsArguments) {
+  {
+    AsyncLogger logger(fd());
+    const std::string name = "copied";
+    char buffer[] = "mutable";
+    EXPECT_TRUE(logger.log("plain 100%%\n"));
+    EXPECT_TRUE(logger.log("%d %u %ld %c\n", -1, 2u, 3L, 'x'));
+    EXPECT_TRUE(logger.log("%.2f %s %s %s\n", 1.5, "literal", name, buffer));
+    logger.flush();
+    EXPECT_EQ(contents(), "plain 100%\n-1 2 3 x\n1.50 literal copied mutable\n");
+  }
+}
+
+TEST_F(AsyncLoggerFixture, NullString) {
+  AsyncLogger logger(fd());
+  const char *missing = nullptr;
+  char *mutableMissing = nullptr;
+  EXPECT_TRUE(logger.log("%s %s\n", missing, mutableMissing));
+  logger.flush();
+  EXPECT_EQ(contents(), "(null) (null)\n");
+}
+
+TEST_F(AsyncLoggerFixture, StringsAreCopied) {
+  AsyncLogger logger(fd());
+  {
+    std::string temporary = "before";
+    logger.log("%s\n", temporary);
+    temporary = "after";
+  }
+  logger.flush();
+  EXPECT_EQ(contents(), "before\n");
+}
+
+TEST_F(AsyncLoggerFixture, DestructorWritesEverything) {
+  {
+    AsyncLogger logger(fd());
+    for (int i = 0; i < 100; ++i) {
+      logger.log("%d\n", i);
+    }
+  }
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    expected += std::to_string(i) + "\n";
+  }
+  EXPECT_EQ(contents(), expected);
+}
+
+TEST_F(AsyncLoggerFixture, BatchesWrites) {
+  AsyncLogger::Options options;
+  // The drainer only runs on flush().
+  options.pollInterval = std::chrono::hours(1);
+  {
+    AsyncLogger logger(fd(), options);
+    // Wait for the first, empty drain pass, so that all messages end up in the next one.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for (int i = 0; i < 100; ++i) {
+      logger.log("message %d\n", i);
+    }
+    logger.flush();
+    EXPECT_EQ(logger.numWrites(), 1);
+  }
+}
+
+TEST_F(AsyncLoggerFixture, LongMessagesAreTruncated) {
+  AsyncLogger::Options options;
+  options.batchSize = 8;
+  {
+    AsyncLogger logger(fd(), options);
+    logger.log("%s", "0123456789");
+    logger.log("%s", "ab");
+  }
+  EXPECT_EQ(contents(), "0123456ab");
+}
+
+TEST_F(AsyncLoggerFixture, DropsWhenFull) {
+  AsyncLogger::Options options;
+  options.bytesPerThread = 256;
+  options.pollInterval = std::chrono::hours(1);
+  AsyncLogger logger(fd(), options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  int numLogged = 0;
+  while (logger.log("%d\n", numLogged)) {
+    ++numLogged;
+  }
+  EXPECT_GT(numLogged, 0);
+  EXPECT_EQ(logger.numDropped(), 1);
+
+  logger.flush();
+  EXPECT_TRUE(logger.log("%d\n", numLogged));
+  logger.flush();
+
+  std::string expected;
+  for (int i = 0; i <= numLogged; ++i) {
+    expected += std::to_string(i) + "\n";
+  }
+  EXPECT_EQ(contents(), expected);
+}
+
+TEST_F(AsyncLoggerFixture, ExitedThreadsAreFreed) {
+  AsyncLogger logger(fd());
+  for (int t = 0; t < 3; ++t) {
+    std::thread([&logger, t]() { logger.log("thread %d\n", t); }).join();
+  }
+  logger.flush();
+  EXPECT_EQ(logger.numThreads(), 0);
+  EXPECT_EQ(contents(), "thread 0\nthread 1\nthread 2\n");
+}
+
+TEST_F(AsyncLoggerFixture, ThreadKeepsOneRingPerLogger) {
+  std::FILE *otherFile = std::tmpfile();
+  {
+    AsyncLogger logger(fd());
+    AsyncLogger other(fileno(otherFile));
+    for (int i = 0; i < 10; ++i) {
+      logger.log("%d\n", i);
+      other.log("%d\n", i);
+    }
+    EXPECT_EQ(logger.numThreads(), 1);
+    EXPECT_EQ(other.numThreads(), 1);
+  }
+  std::fclose(otherFile);
+}
+
+TEST_F(AsyncLoggerFixture, TakesTurnsBetweenThreads) {
+  AsyncLogger::Options options;
+  options.pollInterval = std::chrono::hours(1);
+  AsyncLogger logger(fd(), options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  // The busy thread registers first, so the drainer starts with it. It stays alive until everything is written.
+  std::atomic<bool> logged{false};
+  std::atomic<bool> written{false};
+  std::thread busy([&]() {
+    for (std::size_t i = 0; i < 3 * AsyncLogger::kMessagesPerTurn; ++i) {
+      logger.log("busy\n");
+    }
+    logged = true;
+    while (!written) {
+      std::this_thread::yield();
+    }
+  });
+  while (!logged) {
+    std::this_thread::yield();
+  }
+  logger.log("quiet\n");
+  logger.flush();
+  written = true;
+  busy.join();
+
+  std::string busyTurn;
+  for (std::size_t i = 0; i < AsyncLogger::kMessagesPerTurn; ++i) {
+    busyTurn += "busy\n";
+  }
+  EXPECT_EQ(contents(), busyTurn + "quiet\n" + busyTurn + busyTurn);
+}
+
+TEST_F(AsyncLoggerFixture, MultipleThreads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumMessages = 1000;
+  {
+    AsyncLogger logger(fd());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&logger, t]() {
+        for (int i = 0; i < kNumMessages; ++i) {
+          while (!logger.log("%d %d\n", t, i)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+
+  // The messages of each thread are in order.
+  std::vector<int> next(kNumThreads, 0);
+  std::FILE *in = fdopen(dup(fd()), "r");
+  ASSERT_NE(in, nullptr);
+  std::rewind(in);
+  int t;
+  int i;
+  while (std::fscanf(in, "%d %d\n", &t, &i) == 2) {
+    ASSERT_GE(t, 0);
+    ASSERT_LT(t, kNumThreads);
+    EXPECT_EQ(i, next[t]);
+    next[t] = i + 1;
+  }
+  std::fclose(in);
+  for (int count : next) {
+    EXPECT_EQ(count, kNumMessages);
+  }
+}
+
+}  // namespace AtomicRingBuffer
@@ -9,166 +9,177 @@ namespace AtomicRingBuffer {
 
 // Test operation of an uninitialized buffer
 
-TEST_F(NoBufferAtomicBufferFixture, EmptyBuffer_Size_Capacity) {
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+TYPED_TEST(NoBufferAtomicBufferFixture, EmptyBuffer_Size_Capacity) {
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 }
 
-TEST_F(NoBufferAtomicBufferFixture, EmptyBuffer_Allocate) {
-  Mem mem = ringBuffer.allocate(5, false);
+TYPED_TEST(NoBufferAtomicBufferFixture, EmptyBuffer_Allocate) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(5, false);
   EXPECT_EQ(mem, Mem());
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 }
 
-TEST_F(NoBufferAtomicBufferFixture, EmptyBuffer_Publish) {
+TYPED_TEST(NoBufferAtomicBufferFixture, EmptyBuffer_Publish) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem{buffer, 5};
-    EXPECT_EQ(ringBuffer.publish(mem), 0);
-    EXPECT_EQ(mem.ptr, buffer);
+    Mem mem{this->buffer, 5};
+    EXPECT_EQ(this->ringBuffer.publish(mem), 0);
+    EXPECT_EQ(mem.ptr, this->buffer);
   }
 
   {
     Mem mem;
     mem.len = 5;
-    EXPECT_EQ(ringBuffer.publish(mem), 0);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 0);
   }
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 }
 
-TEST_F(NoBufferAtomicBufferFixture, EmptyBuffer_Peek) {
-  Mem mem = ringBuffer.peek(5, false);
+TYPED_TEST(NoBufferAtomicBufferFixture, EmptyBuffer_Peek) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.peek(5, false);
   EXPECT_EQ(mem, Mem());
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 }
 
-TEST_F(NoBufferAtomicBufferFixture, EmptyBuffer_Consume) {
-  Mem mem{buffer, 5};
-  EXPECT_EQ(ringBuffer.consume(mem), 0);
-  EXPECT_EQ(mem.ptr, buffer);
+TYPED_TEST(NoBufferAtomicBufferFixture, EmptyBuffer_Consume) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem{this->buffer, 5};
+  EXPECT_EQ(this->ringBuffer.consume(mem), 0);
+  EXPECT_EQ(mem.ptr, this->buffer);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 
   Mem mem2{nullptr, 5};
-  EXPECT_EQ(ringBuffer.consume(mem2), 0);
+  EXPECT_EQ(this->ringBuffer.consume(mem2), 0);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), 0);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), 0);
 }
 
 // Test operation on an initialized but empty buffer
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Size_Capacity) {
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Size_Capacity) {
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Allocate) {
-  Mem mem = ringBuffer.allocate(5, false);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Allocate) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(5, false);
   EXPECT_EQ(mem.len, 5);
-  EXPECT_EQ(mem.ptr, buffer);
+  EXPECT_EQ(mem.ptr, this->buffer);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Allocate_Oversize) {
-  Mem mem = ringBuffer.allocate(15, false);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Allocate_Oversize) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(15, false);
   EXPECT_EQ(mem, Mem());
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Allocate_Oversize_Partial) {
-  Mem mem = ringBuffer.allocate(15, true);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Allocate_Oversize_Partial) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(15, true);
   EXPECT_EQ(mem.len, 10);
-  EXPECT_EQ(mem.ptr, buffer);
+  EXPECT_EQ(mem.ptr, this->buffer);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
 /*
  * Test publishing without allocating first.
  */
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Publish) {
-  Mem mem{buffer, 5};
-  EXPECT_EQ(ringBuffer.publish(mem), 0);
-  EXPECT_EQ(mem.ptr, buffer);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Publish) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem{this->buffer, 5};
+  EXPECT_EQ(this->ringBuffer.publish(mem), 0);
+  EXPECT_EQ(mem.ptr, this->buffer);
 
   {
     Mem mem2{nullptr, 5};
-    EXPECT_EQ(ringBuffer.publish(mem2), 0);
+    EXPECT_EQ(this->ringBuffer.publish(mem2), 0);
   }
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Peek) {
-  Mem mem = ringBuffer.peek(5, false);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Peek) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.peek(5, false);
   EXPECT_EQ(mem.len, 0);
   EXPECT_EQ(mem.ptr, nullptr);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
-TEST_F(BufferedAtomicBufferFixture, EmptyBuffer_Consume) {
-  Mem mem{buffer, 5};
-  EXPECT_EQ(ringBuffer.consume(mem), 0);
-  EXPECT_EQ(mem.ptr, buffer);
+TYPED_TEST(BufferedAtomicBufferFixture, EmptyBuffer_Consume) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem{this->buffer, 5};
+  EXPECT_EQ(this->ringBuffer.consume(mem), 0);
+  EXPECT_EQ(mem.ptr, this->buffer);
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
   {
     Mem mem2{nullptr, 5};
-    EXPECT_EQ(ringBuffer.consume(mem2), 0);
+    EXPECT_EQ(this->ringBuffer.consume(mem2), 0);
   }
 
-  EXPECT_EQ(ringBuffer.size(), 0);
-  EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  EXPECT_EQ(this->ringBuffer.size(), 0);
+  EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 }
 
 // Test regular operation: Allocate, publish, peek, consume cycle
 
-TEST_F(BufferedAtomicBufferFixture, FullCycle) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 5; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     // TBD Error Cases: Publish without allocating, publish out of sequence data
-    EXPECT_EQ(ringBuffer.publish(mem), 5);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 5);
 
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
     // TBD Error Cases: Peek partial
-    Mem mem = ringBuffer.peek(5, false);
+    Mem mem = this->ringBuffer.peek(5, false);
     EXPECT_EQ(mem.len, 5);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     // Repeated peek
     {
-      Mem mem2 = ringBuffer.peek(5, false);
+      Mem mem2 = this->ringBuffer.peek(5, false);
       EXPECT_EQ(mem2.len, 5);
       EXPECT_EQ(mem, mem2);
     }
@@ -176,284 +187,291 @@ TEST_F(BufferedAtomicBufferFixture, FullCycle) {
     for (uint8_t i = 0; i < 5; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 5; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 5; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     // TBD Error Cases: Consume without peek, consume out of order
-    EXPECT_EQ(ringBuffer.consume(mem), 5);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 5);
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 }
 
 // Test allocate with partial publish and full peek
 
-TEST_F(BufferedAtomicBufferFixture, FullCycle_PartialPublish_FullPeek) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle_PartialPublish_FullPeek) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 3; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     mem.len = 3;
-    EXPECT_EQ(ringBuffer.publish(mem), 3);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 3);
 
-    EXPECT_EQ(ringBuffer.size(), 3);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
-    Mem mem = ringBuffer.peek(5, true);
+    Mem mem = this->ringBuffer.peek(5, true);
     EXPECT_EQ(mem.len, 3);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 3);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     for (uint8_t i = 0; i < 3; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 3; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 3; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     mem.len = 5;
-    EXPECT_EQ(ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 3);
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 }
 
 // test allocate, partial publish, allocate, peek for the part
-TEST_F(BufferedAtomicBufferFixture, FullCycle_PartialPublish_Allocate_FullPeek) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle_PartialPublish_Allocate_FullPeek) {
+  using Mem = typename TestFixture::Mem;
   {
     // Allocate 5 bytes but publish only 3 bytes.
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 3; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     mem.len = 3;
-    EXPECT_EQ(ringBuffer.publish(mem), 3);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 3);
 
-    EXPECT_EQ(ringBuffer.size(), 3);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
     // Allocate an additional 5 bytes
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer + 5);
-    EXPECT_EQ(ringBuffer.size(), 3);
+    EXPECT_EQ(mem.ptr, this->buffer + 5);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
   }
 
   {
     // Try to read 5 bytes but get only 3
-    Mem mem = ringBuffer.peek(5, true);
+    Mem mem = this->ringBuffer.peek(5, true);
     EXPECT_EQ(mem.len, 3);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 3);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     for (uint8_t i = 0; i < 3; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 3; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 3; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     // Try to consume 5 bytes but consume only 3.
     mem.len = 5;
-    EXPECT_EQ(ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 3);
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 }
 
 // test repeated consumption
-TEST_F(BufferedAtomicBufferFixture, FullCycle_PartialPeek_RepeatedConsume) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle_PartialPeek_RepeatedConsume) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 5; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.publish(mem), 5);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 5);
 
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
-    Mem mem = ringBuffer.peek(3, false);
+    Mem mem = this->ringBuffer.peek(3, false);
     EXPECT_EQ(mem.len, 3);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     for (uint8_t i = 0; i < 5; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 5; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 5; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     // TBD Error Cases: Consume without peek, consume out of order, Consume more than was peeked.
     mem.len = 3;
-    EXPECT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 2);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     // Repeat consumption using the same source pointer
-    EXPECT_EQ(ringBuffer.consume(mem), 0);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 0);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
 }
 
 // test partial peek
-TEST_F(BufferedAtomicBufferFixture, FullCycle_PartialPeek_RepeatedPeek) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle_PartialPeek_RepeatedPeek) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 5; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.publish(mem), 5);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 5);
 
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
-    Mem mem = ringBuffer.peek(3, false);
+    Mem mem = this->ringBuffer.peek(3, false);
     EXPECT_EQ(mem.len, 3);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     for (uint8_t i = 0; i < 5; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 5; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 5; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     // TBD Error Cases: Consume without peek, consume out of order, Consume more than was peeked.
     mem.len = 3;
-    EXPECT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 2);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     // Peek & Consume the remainder
-    mem = ringBuffer.peek(2, false);
+    mem = this->ringBuffer.peek(2, false);
     EXPECT_EQ(mem.len, 2);
 
-    EXPECT_EQ(mem.ptr, buffer + 3);
+    EXPECT_EQ(mem.ptr, this->buffer + 3);
 
     for (uint8_t i = 0; i < 2; ++i) {
       EXPECT_EQ(mem.ptr[i], i + 3);
     }
-    EXPECT_EQ(ringBuffer.consume(mem), 2);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 2);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
   }
 }
 
 // test partial consumption
-TEST_F(BufferedAtomicBufferFixture, FullCycle_FullPeek_PartialConsume) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCycle_FullPeek_PartialConsume) {
+  using Mem = typename TestFixture::Mem;
   {
     // Write 5 bytes to the buffer
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 5; ++i) {
       mem.ptr[i] = i;
     }
 
-    EXPECT_EQ(ringBuffer.publish(mem), 5);
+    EXPECT_EQ(this->ringBuffer.publish(mem), 5);
 
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 
   {
     // Peek 5 bytes
-    Mem mem = ringBuffer.peek(5, false);
+    Mem mem = this->ringBuffer.peek(5, false);
     EXPECT_EQ(mem.len, 5);
 
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 5);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 5);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     for (uint8_t i = 0; i < 5; ++i) {
       EXPECT_EQ(mem.ptr[i], i);
     }
-    for (uint8_t i = 5; i < ringBuffer.capacity(); ++i) {
-      EXPECT_EQ(buffer[i], 0xFF);
+    for (uint8_t i = 5; i < this->ringBuffer.capacity(); ++i) {
+      EXPECT_EQ(this->buffer[i], 0xFF);
     }
 
     // Consume 3 bytes
     mem.len = 3;
-    EXPECT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 2);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
 
     // Peek & Consume the remainder (2 bytes)
 
     // Try overpeeking first (won't work)
-    mem = ringBuffer.peek(5, false);
+    mem = this->ringBuffer.peek(5, false);
     EXPECT_EQ(mem.len, 0);
     EXPECT_EQ(mem.ptr, nullptr);
     // Try overpeeking but accepting a partial result
-    mem = ringBuffer.peek(5, true);
+    mem = this->ringBuffer.peek(5, true);
     EXPECT_EQ(mem.len, 2);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
 
-    EXPECT_EQ(mem.ptr, buffer + 3);
+    EXPECT_EQ(mem.ptr, this->buffer + 3);
 
     for (uint8_t i = 0; i < 2; ++i) {
       EXPECT_EQ(mem.ptr[i], i + 3);
     }
-    EXPECT_EQ(ringBuffer.consume(mem), 2);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.consume(mem), 2);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, SkipPublish) {
+TYPED_TEST(BufferedAtomicBufferFixture, SkipPublish) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
     for (uint8_t i = 0; i < 5; ++i) {
       mem.ptr[i] = i;
     }
 
+    // Multiple producers may publish their allocations in any order, but the data only becomes visible in order.
     Mem mem2{mem.ptr + 3, 2};
-    EXPECT_EQ(ringBuffer.publish(mem2), 0);
+    EXPECT_EQ(this->ringBuffer.publish(mem2), TypeParam::Sync::kMultiProducer ? 2 : 0);
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), TestFixture::kBufferSize);
   }
 }
 
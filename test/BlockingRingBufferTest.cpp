@@ -0,0 +1,190 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/BlockingRingBuffer.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+#include "AtomicRingBuffer/StaticAtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+class BlockingAtomicBufferFixture : public ::testing::Test {
+ public:
+  using Buffer = BlockingRingBuffer<SpscAtomicRingBuffer>;
+  using Mem = Buffer::MemoryRange;
+
+  void SetUp() { ringBuffer.init(buffer, kBufferSize); }
+
+  constexpr static const Buffer::size_type kBufferSize = 16;
+  uint8_t buffer[kBufferSize];
+
+  Buffer ringBuffer;
+};
+
+const BlockingAtomicBufferFixture::Buffer::size_type BlockingAtomicBufferFixture::kBufferSize;
+
+TEST_F(BlockingAtomicBufferFixture, NoWaitWhenAvailable) {
+  Mem mem = ringBuffer.allocateWait(4, false);
+  EXPECT_EQ(mem, (Mem{buffer, 4}));
+  EXPECT_EQ(ringBuffer.publish(mem), 4);
+  EXPECT_EQ(ringBuffer.peekWait(4, false), mem);
+}
+
+TEST_F(BlockingAtomicBufferFixture, PeekTimeout) {
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(ringBuffer.peekWait(1, true, std::chrono::milliseconds(20)), Mem());
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(BlockingAtomicBufferFixture, AllocateTimeout) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(kBufferSize, false)), kBufferSize);
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(ringBuffer.allocateWait(1, true, std::chrono::milliseconds(20)), Mem());
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(BlockingAtomicBufferFixture, PublishWakesConsumer) {
+  std::thread producer([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Mem mem = ringBuffer.allocate(3, false);
+    mem.ptr[0] = 42;
+    ringBuffer.publish(mem);
+  });
+
+  Mem mem = ringBuffer.peekWait(3, false);
+  producer.join();
+  ASSERT_EQ(mem.len, 3);
+  EXPECT_EQ(mem.ptr[0], 42);
+}
+
+TEST_F(BlockingAtomicBufferFixture, ConsumeWakesProducer) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(kBufferSize, false)), kBufferSize);
+
+  std::thread consumer([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ringBuffer.consume(ringBuffer.peek(5, false));
+  });
+
+  Mem mem = ringBuffer.allocateWait(5, false, std::chrono::seconds(10));
+  consumer.join();
+  EXPECT_EQ(mem, (Mem{buffer, 5}));
+}
+
+TEST_F(BlockingAtomicBufferFixture, TransferSequence) {
+  constexpr uint32_t kNumBytes = 100000;
+
+  std::thread producer([this]() {
+    for (uint32_t i = 0; i < kNumBytes;) {
+      Mem mem = ringBuffer.allocateWait(kNumBytes - i, true);
+      for (Buffer::size_type j = 0; j < mem.len; ++j) {
+        mem.ptr[j] = static_cast<uint8_t>(i + j);
+      }
+      i += ringBuffer.publish(mem);
+    }
+  });
+
+  bool valid = true;
+  for (uint32_t i = 0; i < kNumBytes;) {
+    Mem mem = ringBuffer.peekWait(kNumBytes - i, true);
+    for (Buffer::size_type j = 0; j < mem.len; ++j) {
+      valid &= (mem.ptr[j] == static_cast<uint8_t>(i + j));
+    }
+    i += ringBuffer.consume(mem);
+  }
+  producer.join();
+
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST(BlockingRingBuffer, GivesUpOnRangeAcrossEnd) {
+  using Buffer = BlockingRingBuffer<SpscAtomicRingBuffer>;
+  using Mem = Buffer::MemoryRange;
+  uint8_t buffer[10];
+  Buffer ringBuffer;
+  ringBuffer.init(buffer, sizeof(buffer));
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(8, false)), 8);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(8, false)), 8);
+
+  // The buffer is empty, but only 2 bytes are left before its end.
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(ringBuffer.allocateWait(5, false, std::chrono::seconds(10)), Mem());
+  EXPECT_EQ(ringBuffer.allocateWait(5, false), Mem());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+
+  Mem mem = ringBuffer.allocateWait(5, true);
+  EXPECT_EQ(mem, (Mem{buffer + 8, 2}));
+  ASSERT_EQ(ringBuffer.publish(mem), 2);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocateWait(3, false)), 3);
+
+  // 5 bytes are available, but split at the end of the buffer.
+  EXPECT_EQ(ringBuffer.peekWait(5, false, std::chrono::seconds(10)), Mem());
+  EXPECT_EQ(ringBuffer.peekWait(5, false), Mem());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+  EXPECT_EQ(ringBuffer.peekWait(5, true), (Mem{buffer + 8, 2}));
+}
+
+TEST(BlockingRingBuffer, WrapsOtherBuffers) {
+  BlockingRingBuffer<StaticAtomicRingBuffer<8>> staticBuffer;
+  auto mem = staticBuffer.allocateWait(8, false);
+  EXPECT_EQ(mem.len, 8);
+  EXPECT_EQ(staticBuffer.publish(mem), 8);
+  EXPECT_EQ(staticBuffer.peekWait(8, false, std::chrono::milliseconds(1)).len, 8);
+
+  BlockingRingBuffer<ObjectRingBuffer<uint32_t, 4>> objectBuffer;
+  auto elem = objectBuffer.allocateWait(1, false);
+  ASSERT_EQ(elem.len, 1);
+  *elem.ptr = 42;
+  EXPECT_EQ(objectBuffer.publish(elem), 1);
+  elem = objectBuffer.peekWait(1, false, std::chrono::milliseconds(1));
+  ASSERT_EQ(elem.len, 1);
+  EXPECT_EQ(*elem.ptr, 42);
+  EXPECT_EQ(objectBuffer.consume(elem), 1);
+}
+
+TEST(BlockingRingBuffer, PushWakesConsumer) {
+  BlockingRingBuffer<ObjectRingBuffer<uint32_t, 4>> objectBuffer;
+  std::thread producer([&objectBuffer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    objectBuffer.push(42);
+  });
+
+  // Without a timeout, a missed wake-up would block forever.
+  const auto elem = objectBuffer.peekWait(1, false);
+  producer.join();
+  ASSERT_EQ(elem.len, 1);
+  EXPECT_EQ(*elem.ptr, 42);
+}
+
+TEST(BlockingRingBuffer, PopWakesProducer) {
+  BlockingRingBuffer<ObjectRingBuffer<uint32_t, 2>> objectBuffer;
+  ASSERT_TRUE(objectBuffer.push(1));
+  ASSERT_TRUE(objectBuffer.push(2));
+  std::thread consumer([&objectBuffer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    objectBuffer.pop();
+  });
+
+  EXPECT_EQ(objectBuffer.allocateWait(1, false).len, 1);
+  consumer.join();
+}
+
+TEST_F(BlockingAtomicBufferFixture, LeaseWakesConsumer) {
+  std::thread producer([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto lease = ringBuffer.allocateLease(2, false);
+    lease[0] = 7;
+  });
+
+  Mem mem = ringBuffer.peekWait(2, false);
+  producer.join();
+  ASSERT_EQ(mem.len, 2);
+  EXPECT_EQ(mem.ptr[0], 7);
+}
+
+}  // namespace AtomicRingBuffer
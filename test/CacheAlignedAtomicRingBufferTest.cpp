@@ -0,0 +1,13 @@
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+// The cache aligned buffer runs the generic tests through AtomicRingBufferTypes in Mocks.h, only its layout is checked
+// here.
+
+static_assert(sizeof(AtomicRingBuffer) < kCacheLineSize, "Default layout must stay compact.");
+static_assert(alignof(CacheAlignedAtomicRingBuffer) == kCacheLineSize, "Cache aligned layout must be line aligned.");
+static_assert(sizeof(CacheAlignedAtomicRingBuffer) == 3 * kCacheLineSize,
+              "Buffer description, producer and consumer indices must occupy one cache line each.");
+
+}  // namespace AtomicRingBuffer
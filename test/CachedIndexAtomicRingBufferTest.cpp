@@ -0,0 +1,61 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "Mocks.h"
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+using CachedIndexAtomicBufferFixture = BufferedAtomicBufferFixture<CachedIndexAtomicRingBuffer>;
+
+TEST_F(CachedIndexAtomicBufferFixture, PeekSeesLaterPublish) {
+  Mem mem = ringBuffer.allocate(3, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 3);
+
+  // Caches the write index.
+  EXPECT_EQ(ringBuffer.peek(3, false).len, 3);
+
+  mem = ringBuffer.allocate(4, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 4);
+
+  // The cached write index is outdated and must be refreshed.
+  mem = ringBuffer.peek(7, false);
+  EXPECT_EQ(mem.len, 7);
+  EXPECT_EQ(mem.ptr, buffer);
+  EXPECT_EQ(ringBuffer.consume(mem), 7);
+}
+
+TEST_F(CachedIndexAtomicBufferFixture, AllocateSeesLaterConsume) {
+  Mem mem = ringBuffer.allocate(kBufferSize, false);
+  ASSERT_EQ(ringBuffer.publish(mem), kBufferSize);
+
+  // Buffer is full. Caches the read index.
+  EXPECT_EQ(ringBuffer.allocate(1, true), Mem());
+
+  mem = ringBuffer.peek(4, false);
+  ASSERT_EQ(ringBuffer.consume(mem), 4);
+
+  // The cached read index is outdated and must be refreshed.
+  mem = ringBuffer.allocate(4, false);
+  EXPECT_EQ(mem.len, 4);
+  EXPECT_EQ(mem.ptr, buffer);
+}
+
+TEST_F(CachedIndexAtomicBufferFixture, ConsumeLimitedToPeekedData) {
+  Mem mem = ringBuffer.allocate(3, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 3);
+
+  Mem peeked = ringBuffer.peek(3, false);
+  ASSERT_EQ(peeked.len, 3);
+
+  mem = ringBuffer.allocate(3, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 3);
+
+  // Only the data known to the consumer can be consumed.
+  peeked.len = 6;
+  EXPECT_EQ(ringBuffer.consume(peeked), 3);
+  EXPECT_EQ(ringBuffer.size(), 3);
+}
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,124 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AtomicRingBuffer/HugePageMemory.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+// Beyond the former uint16_t limit.
+TEST(ObjectRingBufferCapacity, LargeCapacity) {
+  std::unique_ptr<ObjectRingBuffer<uint8_t, 100000>> objectBuffer(new ObjectRingBuffer<uint8_t, 100000>());
+  EXPECT_EQ(objectBuffer->capacity(), 100000);
+  EXPECT_EQ(objectBuffer->allocate(100000, false).len, 100000);
+}
+
+TEST(BasicObjectRingBuffer, ExternalStorage) {
+  using Buffer_t = BasicObjectRingBuffer<uint64_t>;
+  std::vector<Buffer_t::buffer_element_type> storage(5);
+
+  Buffer_t objectBuffer;
+  EXPECT_EQ(objectBuffer.capacity(), 0);
+  EXPECT_FALSE(objectBuffer.push(1));
+
+  objectBuffer.init(storage.data(), storage.size());
+  EXPECT_EQ(objectBuffer.capacity(), 5);
+  for (uint64_t i = 0; i < 5; ++i) {
+    EXPECT_TRUE(objectBuffer.push(i));
+  }
+  EXPECT_FALSE(objectBuffer.push(5));
+  EXPECT_EQ(objectBuffer.front(), reinterpret_cast<uint64_t *>(storage.data()));
+
+  uint64_t popped = 0;
+  EXPECT_TRUE(objectBuffer.pop(popped));
+  EXPECT_EQ(popped, 0);
+}
+
+TEST(DynamicObjectRingBuffer, CapacityChosenAtRuntime) {
+  DynamicObjectRingBuffer<std::string> objectBuffer(3);
+  EXPECT_EQ(objectBuffer.capacity(), 3);
+  EXPECT_TRUE(objectBuffer.emplace("a"));
+  EXPECT_TRUE(objectBuffer.emplace("b"));
+  EXPECT_TRUE(objectBuffer.emplace("c"));
+  EXPECT_FALSE(objectBuffer.emplace("d"));
+
+  std::string popped;
+  EXPECT_TRUE(objectBuffer.pop(popped));
+  EXPECT_EQ(popped, "a");
+  EXPECT_TRUE(objectBuffer.emplace("d"));
+  while (objectBuffer.pop()) {
+  }
+  EXPECT_TRUE(objectBuffer.empty());
+}
+
+namespace {
+
+/**
+ * \brief Allocator that counts the bytes it hands out.
+ */
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  explicit CountingAllocator(std::size_t *allocated) : allocated(allocated) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &other) : allocated(other.allocated) {}
+
+  T *allocate(const std::size_t n) {
+    *allocated += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *ptr, const std::size_t n) {
+    *allocated -= n * sizeof(T);
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  std::size_t *allocated;
+};
+
+}  // namespace
+
+TEST(DynamicObjectRingBuffer, UsesAllocator) {
+  std::size_t allocated = 0;
+  {
+    DynamicObjectRingBuffer<uint32_t, CountingAllocator<uint32_t>> objectBuffer(
+        10, CountingAllocator<uint32_t>(&allocated));
+    EXPECT_EQ(allocated, 10 * sizeof(uint32_t));
+    EXPECT_EQ(objectBuffer.capacity(), 10);
+  }
+  EXPECT_EQ(allocated, 0);
+}
+
+#ifdef __linux__
+
+TEST(HugePageMemory, BacksObjectRingBuffer) {
+  // Falls back to transparent huge pages if the hugetlbfs pool is empty.
+  HugePageMemory memory;
+  ASSERT_TRUE(memory.map(1));
+  EXPECT_EQ(memory.size(), HugePageMemory::hugePageSize());
+
+  using Buffer_t = BasicObjectRingBuffer<uint64_t>;
+  Buffer_t objectBuffer;
+  objectBuffer.init(memory.data(), memory.size() / Buffer_t::kElementSize);
+  EXPECT_EQ(objectBuffer.capacity(), HugePageMemory::hugePageSize() / sizeof(uint64_t));
+
+  const std::vector<uint64_t> values(objectBuffer.capacity(), 42);
+  EXPECT_EQ(objectBuffer.push(values.data(), values.size()), values.size());
+  std::vector<uint64_t> popped(values.size());
+  EXPECT_EQ(objectBuffer.pop(popped.data(), popped.size()), values.size());
+  EXPECT_EQ(popped, values);
+
+  memory.unmap();
+  EXPECT_EQ(memory.data(), nullptr);
+}
+
+#endif  // __linux__
+
+}  // namespace AtomicRingBuffer
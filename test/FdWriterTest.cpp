@@ -0,0 +1,132 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/FdWriter.h"
+
+namespace AtomicRingBuffer {
+
+class FdWriterFixture : public ::testing::Test {
+ public:
+  void SetUp() {
+    ringBuffer.init(buffer, sizeof(buffer));
+    ASSERT_EQ(pipe(pipeFds), 0);
+  }
+
+  void TearDown() {
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+  }
+
+  void produce(const char *text) {
+    const std::size_t len = strlen(text);
+    const AtomicRingBuffer::MemoryRangePair data = ringBuffer.allocateSegments(len, false);
+    ASSERT_EQ(data.len(), len);
+    memcpy(data.first.ptr, text, data.first.len);
+    memcpy(data.second.ptr, text + data.first.len, data.second.len);
+    ASSERT_EQ(ringBuffer.publish(data), len);
+  }
+
+  std::string readPipe(const std::size_t len) {
+    std::string text(len, '\0');
+    EXPECT_EQ(read(pipeFds[0], &text[0], len), static_cast<ssize_t>(len));
+    return text;
+  }
+
+  uint8_t buffer[16];
+  AtomicRingBuffer ringBuffer;
+  int pipeFds[2];
+};
+
+TEST_F(FdWriterFixture, EmptyBufferWritesNothing) { EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer), 0); }
+
+TEST_F(FdWriterFixture, WritesContiguousData) {
+  produce("hello");
+  EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer), 5);
+  EXPECT_TRUE(ringBuffer.empty());
+  EXPECT_EQ(readPipe(5), "hello");
+}
+
+TEST_F(FdWriterFixture, WritesBothSegmentsAtOnce) {
+  produce("0123456789AB");
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(12, false)), 12);
+  produce("wrapped!");
+
+  EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer), 8);
+  EXPECT_TRUE(ringBuffer.empty());
+  EXPECT_EQ(readPipe(8), "wrapped!");
+}
+
+TEST_F(FdWriterFixture, MaxLenLimitsWrite) {
+  produce("0123456789");
+  EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer, 4), 4);
+  EXPECT_EQ(ringBuffer.size(), 6);
+  EXPECT_EQ(readPipe(4), "0123");
+}
+
+TEST_F(FdWriterFixture, ConsumesIntoSecondSegment) {
+  produce("0123456789AB");
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(12, false)), 12);
+  produce("wrapped!");
+
+  EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer, 6), 6);
+  EXPECT_EQ(ringBuffer.size(), 2);
+  EXPECT_EQ(ringBuffer.peek(2, false).ptr, buffer + 2);
+  EXPECT_EQ(readPipe(6), "wrappe");
+}
+
+TEST_F(FdWriterFixture, FailedWriteConsumesNothing) {
+  produce("data");
+  const int readOnly = open("/dev/null", O_RDONLY);
+  ASSERT_GE(readOnly, 0);
+  EXPECT_EQ(writeToFd(readOnly, ringBuffer), -1);
+  EXPECT_EQ(errno, EBADF);
+  close(readOnly);
+  EXPECT_EQ(ringBuffer.size(), 4);
+}
+
+TEST(FdWriter, ConsumesOnlyAcceptedBytes) {
+  // Larger than the capacity of a pipe, so that a non-blocking write is partial.
+  std::vector<uint8_t> storage(1024 * 1024);
+  AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage.data(), storage.size());
+  const AtomicRingBuffer::MemoryRange data = ringBuffer.allocate(storage.size(), false);
+  ASSERT_EQ(data.len, storage.size());
+  for (std::size_t i = 0; i < data.len; ++i) {
+    data.ptr[i] = static_cast<uint8_t>(i);
+  }
+  ASSERT_EQ(ringBuffer.publish(data), data.len);
+
+  int pipeFds[2];
+  ASSERT_EQ(pipe(pipeFds), 0);
+  ASSERT_EQ(fcntl(pipeFds[1], F_SETFL, O_NONBLOCK), 0);
+
+  const ssize_t written = writeToFd(pipeFds[1], ringBuffer);
+  ASSERT_GT(written, 0);
+  ASSERT_LT(static_cast<std::size_t>(written), storage.size());
+  EXPECT_EQ(ringBuffer.size(), storage.size() - static_cast<std::size_t>(written));
+  EXPECT_EQ(ringBuffer.peek(1, false).ptr, storage.data() + written);
+
+  // The pipe is full.
+  EXPECT_EQ(writeToFd(pipeFds[1], ringBuffer), -1);
+  EXPECT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+  EXPECT_EQ(ringBuffer.size(), storage.size() - static_cast<std::size_t>(written));
+
+  std::vector<uint8_t> received(static_cast<std::size_t>(written));
+  ASSERT_EQ(read(pipeFds[0], received.data(), received.size()), written);
+  EXPECT_TRUE(std::equal(received.begin(), received.end(), storage.begin()));
+
+  close(pipeFds[0]);
+  close(pipeFds[1]);
+}
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,193 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <new>
+#include <string>
+#include <utility>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+static_assert(sizeof(WriteLease<AtomicRingBuffer>) == sizeof(void *) + sizeof(AtomicRingBuffer::MemoryRange),
+              "A lease holds nothing but the buffer and the range.");
+
+class LeaseFixture : public ::testing::Test {
+ public:
+  using Mem = AtomicRingBuffer::MemoryRange;
+
+  void SetUp() { ringBuffer.init(buffer, kBufferSize); }
+
+  constexpr static const AtomicRingBuffer::size_type kBufferSize = 16;
+  uint8_t buffer[kBufferSize];
+
+  AtomicRingBuffer ringBuffer;
+};
+
+const AtomicRingBuffer::size_type LeaseFixture::kBufferSize;
+
+TEST_F(LeaseFixture, PublishOnDestruction) {
+  {
+    auto lease = ringBuffer.allocateLease(4, false);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease.data(), buffer);
+    EXPECT_EQ(lease.size(), 4);
+    lease[0] = 42;
+    EXPECT_TRUE(ringBuffer.empty());
+  }
+  EXPECT_EQ(ringBuffer.size(), 4);
+  EXPECT_EQ(ringBuffer.peek(4, false), (Mem{buffer, 4}));
+}
+
+TEST_F(LeaseFixture, ConsumeOnDestruction) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  {
+    auto lease = ringBuffer.peekLease(4, false);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease.data(), buffer);
+    EXPECT_EQ(lease.size(), 4);
+  }
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(LeaseFixture, FailedAllocationIsEmpty) {
+  auto lease = ringBuffer.allocateLease(kBufferSize + 1, false);
+  EXPECT_FALSE(lease);
+  EXPECT_EQ(lease.commit(), 0);
+
+  auto readLease = ringBuffer.peekLease(1, false);
+  EXPECT_FALSE(readLease);
+}
+
+TEST_F(LeaseFixture, CommitShorterReturnsRest) {
+  auto lease = ringBuffer.allocateLease(8, false);
+  ASSERT_EQ(lease.size(), 8);
+  EXPECT_EQ(lease.commit(3), 3);
+  EXPECT_FALSE(lease);
+  EXPECT_EQ(ringBuffer.size(), 3);
+
+  // The next allocation continues directly behind the published bytes and can be published in order.
+  auto next = ringBuffer.allocateLease(2, false);
+  EXPECT_EQ(next.data(), buffer + 3);
+  EXPECT_EQ(next.commit(), 2);
+  EXPECT_EQ(ringBuffer.size(), 5);
+  EXPECT_EQ(ringBuffer.allocate(kBufferSize - 5, false).len, kBufferSize - 5);
+}
+
+TEST_F(LeaseFixture, OutOfOrderCommitKeepsLease) {
+  auto first = ringBuffer.allocateLease(4, false);
+  auto second = ringBuffer.allocateLease(4, false);
+  EXPECT_EQ(second.commit(), 0);
+  EXPECT_EQ(second.size(), 4);
+  EXPECT_TRUE(ringBuffer.empty());
+
+  // Once the earlier allocation is published, the rejected one can be committed again.
+  EXPECT_EQ(first.commit(), 4);
+  EXPECT_EQ(second.commit(), 4);
+  EXPECT_FALSE(second);
+  EXPECT_EQ(ringBuffer.size(), 8);
+}
+
+TEST_F(LeaseFixture, NestedLeasesCommittedInOrder) {
+  {
+    auto outer = ringBuffer.allocateLease(4, false);
+    auto inner = ringBuffer.allocateLease(4, false);
+    EXPECT_EQ(outer.commit(), 4);
+  }
+  EXPECT_EQ(ringBuffer.size(), 8);
+  EXPECT_EQ(ringBuffer.publish(ringBuffer.allocate(2, false)), 2);
+}
+
+#ifndef NDEBUG
+TEST_F(LeaseFixture, OutOfOrderReleaseAsserts) {
+  EXPECT_DEATH(
+      {
+        auto outer = ringBuffer.allocateLease(4, false);
+        auto inner = ringBuffer.allocateLease(4, false);
+      },
+      "allocation order");
+}
+
+TEST_F(LeaseFixture, CommitShorterAfterOtherAllocationAsserts) {
+  EXPECT_DEATH(
+      {
+        auto first = ringBuffer.allocateLease(4, false);
+        auto second = ringBuffer.allocateLease(4, false);
+        first.commit(1);
+      },
+      "most recent allocation");
+}
+#endif
+
+TEST_F(LeaseFixture, CommitZeroReturnsAll) {
+  auto lease = ringBuffer.allocateLease(8, false);
+  EXPECT_EQ(lease.commit(0), 0);
+  EXPECT_TRUE(ringBuffer.empty());
+  EXPECT_EQ(ringBuffer.allocate(kBufferSize, false).len, kBufferSize);
+}
+
+TEST_F(LeaseFixture, ReadCommitShorterLeavesRest) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(6, false)), 6);
+  auto lease = ringBuffer.peekLease(6, false);
+  EXPECT_EQ(lease.commit(2), 2);
+  EXPECT_EQ(ringBuffer.peek(6, true), (Mem{buffer + 2, 4}));
+}
+
+TEST_F(LeaseFixture, MoveTransfersOwnership) {
+  auto lease = ringBuffer.allocateLease(4, false);
+  {
+    WriteLease<AtomicRingBuffer> moved(std::move(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(moved.size(), 4);
+  }
+  EXPECT_EQ(ringBuffer.size(), 4);
+
+  // Assigning to a lease commits what it held before.
+  lease = ringBuffer.allocateLease(2, false);
+  lease = ringBuffer.allocateLease(3, false);
+  EXPECT_EQ(ringBuffer.size(), 6);
+  lease.commit();
+  EXPECT_EQ(ringBuffer.size(), 9);
+
+  ReadLease<AtomicRingBuffer> readLease;
+  readLease = ringBuffer.peekLease(9, false);
+  EXPECT_EQ(readLease.size(), 9);
+  ReadLease<AtomicRingBuffer> movedRead(std::move(readLease));
+  EXPECT_EQ(readLease.commit(), 0);
+  EXPECT_EQ(movedRead.commit(), 9);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST(ObjectRingBufferLease, ConstructInPlace) {
+  ObjectRingBuffer<std::string, 4> objectBuffer;
+  {
+    auto lease = objectBuffer.allocateLease(2, false);
+    ASSERT_EQ(lease.size(), 2);
+    new (&lease[0]) std::string("first");
+    new (&lease[1]) std::string("second");
+  }
+  EXPECT_EQ(objectBuffer.size(), 2);
+
+  {
+    auto lease = objectBuffer.peekLease(2, false);
+    ASSERT_EQ(lease.size(), 2);
+    EXPECT_EQ(lease[0], "first");
+    EXPECT_EQ(lease[1], "second");
+    for (const std::string &element : lease) {
+      element.~basic_string();
+    }
+  }
+  EXPECT_TRUE(objectBuffer.empty());
+}
+
+TEST(ObjectRingBufferLease, CommitShorterReturnsRest) {
+  ObjectRingBuffer<uint32_t, 4> objectBuffer;
+  auto lease = objectBuffer.allocateLease(4, false);
+  lease[0] = 7;
+  EXPECT_EQ(lease.commit(1), 1);
+  EXPECT_EQ(objectBuffer.allocateLease(3, false).size(), 3);
+  EXPECT_EQ(objectBuffer.size(), 4);
+}
+
+}  // namespace AtomicRingBuffer
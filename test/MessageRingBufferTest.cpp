@@ -0,0 +1,204 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "AtomicRingBuffer/MessageRingBuffer.h"
+#include "AtomicRingBuffer/MirroredMemory.h"
+
+namespace AtomicRingBuffer {
+
+class MessageRingBufferFixture : public ::testing::Test {
+ public:
+  using View = MessageRingBuffer::MessageView;
+
+  void SetUp() { messageBuffer.init(buffer, kBufferSize); }
+
+  std::string read() {
+    const View message = messageBuffer.tryRead();
+    if (message.ptr == nullptr) {
+      return "<none>";
+    }
+    std::string result(reinterpret_cast<const char *>(message.ptr), message.len);
+    EXPECT_TRUE(messageBuffer.consume(message));
+    return result;
+  }
+
+  bool write(const std::string &text) { return messageBuffer.tryWrite(text.data(), text.size()); }
+
+  constexpr static const MessageRingBuffer::size_type kBufferSize = 32;
+  alignas(4) uint8_t buffer[kBufferSize];
+
+  MessageRingBuffer messageBuffer;
+};
+
+const MessageRingBuffer::size_type MessageRingBufferFixture::kBufferSize;
+
+TEST_F(MessageRingBufferFixture, NewBufferIsEmpty) {
+  EXPECT_TRUE(messageBuffer.empty());
+  EXPECT_EQ(messageBuffer.tryRead(), View());
+  EXPECT_EQ(messageBuffer.maxMessageLen(), kBufferSize - MessageRingBuffer::kHeaderSize);
+}
+
+TEST_F(MessageRingBufferFixture, WriteRead) {
+  ASSERT_TRUE(write("hello"));
+  ASSERT_TRUE(write("world!"));
+  EXPECT_FALSE(messageBuffer.empty());
+
+  // Reading twice without consuming returns the same message.
+  const View first = messageBuffer.tryRead();
+  EXPECT_EQ(messageBuffer.tryRead(), first);
+  EXPECT_EQ(first.ptr, buffer + MessageRingBuffer::kHeaderSize);
+  EXPECT_EQ(first.len, 5);
+
+  EXPECT_EQ(read(), "hello");
+  EXPECT_EQ(read(), "world!");
+  EXPECT_EQ(read(), "<none>");
+  EXPECT_TRUE(messageBuffer.empty());
+}
+
+TEST_F(MessageRingBufferFixture, EmptyMessage) {
+  ASSERT_TRUE(write(""));
+  const View message = messageBuffer.tryRead();
+  EXPECT_NE(message.ptr, nullptr);
+  EXPECT_EQ(message.len, 0);
+  EXPECT_TRUE(messageBuffer.consume(message));
+  EXPECT_TRUE(messageBuffer.empty());
+}
+
+TEST_F(MessageRingBufferFixture, ReserveCommit) {
+  MessageRingBuffer::MemoryRange payload = messageBuffer.reserve(3);
+  ASSERT_NE(payload.ptr, nullptr);
+  EXPECT_EQ(payload.len, 3);
+  memcpy(payload.ptr, "abc", 3);
+
+  // Reserved messages are not visible before they are committed.
+  EXPECT_EQ(messageBuffer.tryRead(), View());
+  EXPECT_TRUE(messageBuffer.commit(payload));
+  EXPECT_EQ(read(), "abc");
+}
+
+TEST_F(MessageRingBufferFixture, RejectWhenFull) {
+  // Each record takes 4 bytes of header and 12 bytes of payload.
+  ASSERT_TRUE(write(std::string(12, 'a')));
+  ASSERT_TRUE(write(std::string(12, 'b')));
+  EXPECT_FALSE(write(""));
+  EXPECT_EQ(messageBuffer.reserve(1).ptr, nullptr);
+
+  EXPECT_EQ(read(), std::string(12, 'a'));
+  EXPECT_TRUE(write("c"));
+}
+
+TEST_F(MessageRingBufferFixture, RejectOversized) {
+  EXPECT_FALSE(write(std::string(kBufferSize - MessageRingBuffer::kHeaderSize + 1, 'x')));
+  EXPECT_TRUE(write(std::string(kBufferSize - MessageRingBuffer::kHeaderSize, 'x')));
+  EXPECT_EQ(read(), std::string(kBufferSize - MessageRingBuffer::kHeaderSize, 'x'));
+}
+
+TEST_F(MessageRingBufferFixture, SkipAtEndOfBuffer) {
+  ASSERT_TRUE(write(std::string(16, 'a')));  // 20 bytes
+  EXPECT_EQ(read(), std::string(16, 'a'));
+
+  // 12 bytes are left in front of the end, but the record needs 16. It moves to the beginning.
+  ASSERT_TRUE(write(std::string(10, 'b')));
+  const View message = messageBuffer.tryRead();
+  EXPECT_EQ(message.ptr, buffer + MessageRingBuffer::kHeaderSize);
+  EXPECT_EQ(read(), std::string(10, 'b'));
+  EXPECT_TRUE(messageBuffer.empty());
+
+  // The following records continue behind it.
+  ASSERT_TRUE(write("c"));
+  EXPECT_EQ(messageBuffer.tryRead().ptr, buffer + 16 + MessageRingBuffer::kHeaderSize);
+  EXPECT_EQ(read(), "c");
+}
+
+TEST_F(MessageRingBufferFixture, SkipNeedsFreeTail) {
+  ASSERT_TRUE(write(std::string(16, 'a')));  // 20 bytes, 12 bytes left in front of the end.
+  ASSERT_TRUE(write(std::string(4, 'b')));   // 8 bytes, 4 bytes left in front of the end.
+
+  // The skip marker fits, but the beginning of the buffer is still in use.
+  EXPECT_FALSE(write(std::string(4, 'c')));
+  EXPECT_EQ(read(), std::string(16, 'a'));
+  ASSERT_TRUE(write(std::string(4, 'c')));
+  EXPECT_EQ(read(), std::string(4, 'b'));
+  EXPECT_EQ(read(), std::string(4, 'c'));
+}
+
+TEST_F(MessageRingBufferFixture, SkipWaitsForOutstandingReservation) {
+  // 24 bytes, 8 bytes left in front of the end.
+  const MessageRingBuffer::MemoryRange first = messageBuffer.reserve(20);
+  ASSERT_NE(first.ptr, nullptr);
+
+  // The skip marker cannot be published before the first record. The reservation fails without blocking the buffer.
+  EXPECT_EQ(messageBuffer.reserve(8).ptr, nullptr);
+
+  memset(first.ptr, 'a', first.len);
+  ASSERT_TRUE(messageBuffer.commit(first));
+  EXPECT_EQ(read(), std::string(20, 'a'));
+  ASSERT_TRUE(write(std::string(8, 'b')));
+  EXPECT_EQ(read(), std::string(8, 'b'));
+  EXPECT_TRUE(messageBuffer.empty());
+}
+
+TEST_F(MessageRingBufferFixture, TransferSequence) {
+  constexpr uint32_t kNumMessages = 20000;
+
+  std::thread producer([this]() {
+    for (uint32_t i = 0; i < kNumMessages;) {
+      // Messages of 0 to 9 bytes, each byte holding the message number.
+      const std::string message(i % 10, static_cast<char>(i));
+      if (write(message)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  bool valid = true;
+  for (uint32_t i = 0; i < kNumMessages;) {
+    const View message = messageBuffer.tryRead();
+    if (message.ptr == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    valid &= (message.len == i % 10);
+    for (MessageRingBuffer::size_type j = 0; j < message.len; ++j) {
+      valid &= (message.ptr[j] == static_cast<uint8_t>(i));
+    }
+    valid &= messageBuffer.consume(message);
+    ++i;
+  }
+  producer.join();
+
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(messageBuffer.empty());
+}
+
+#ifdef __linux__
+
+TEST(MirroredMessageRingBuffer, NoSkipAtEndOfBuffer) {
+  MirroredMemory memory;
+  ASSERT_TRUE(memory.map(1));
+  MirroredMessageRingBuffer messageBuffer;
+  messageBuffer.init(memory.data(), memory.size());
+
+  // Move close to the end of the buffer, leaving 8 bytes.
+  const std::string filler(memory.size() - 8 - MirroredMessageRingBuffer::kHeaderSize, 'a');
+  ASSERT_TRUE(messageBuffer.tryWrite(filler.data(), filler.size()));
+  ASSERT_TRUE(messageBuffer.consume(messageBuffer.tryRead()));
+
+  const std::string text = "crosses the end";
+  ASSERT_TRUE(messageBuffer.tryWrite(text.data(), text.size()));
+  const auto message = messageBuffer.tryRead();
+  EXPECT_EQ(message.ptr, memory.data() + memory.size() - 8 + MirroredMessageRingBuffer::kHeaderSize);
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(message.ptr), message.len), text);
+  EXPECT_TRUE(messageBuffer.consume(message));
+  EXPECT_TRUE(messageBuffer.empty());
+}
+
+#endif  // __linux__
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,140 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/MirroredMemory.h"
+
+#ifdef __linux__
+
+namespace AtomicRingBuffer {
+
+class MirroredAtomicBufferFixture : public ::testing::Test {
+ public:
+  using Mem = MirroredAtomicRingBuffer::MemoryRange;
+
+  void SetUp() {
+    ASSERT_TRUE(memory.map(1));
+    ringBuffer.init(memory.data(), memory.size());
+  }
+
+  // Move the indices close to the end of the buffer, leaving kTail bytes before the wrap-around point.
+  void advanceToEnd() {
+    const MirroredAtomicRingBuffer::size_type len = memory.size() - kTail;
+    Mem mem = ringBuffer.allocate(len, false);
+    ASSERT_EQ(ringBuffer.publish(mem), len);
+    mem = ringBuffer.peek(len, false);
+    ASSERT_EQ(ringBuffer.consume(mem), len);
+    ASSERT_TRUE(ringBuffer.empty());
+  }
+
+  constexpr static const MirroredAtomicRingBuffer::size_type kTail = 5;
+
+  MirroredMemory memory;
+  MirroredAtomicRingBuffer ringBuffer;
+};
+
+const MirroredAtomicRingBuffer::size_type MirroredAtomicBufferFixture::kTail;
+
+TEST_F(MirroredAtomicBufferFixture, MemoryIsMirrored) {
+  EXPECT_EQ(memory.size() % MirroredMemory::pageSize(), 0);
+
+  memory.data()[0] = 42;
+  EXPECT_EQ(memory.data()[memory.size()], 42);
+  memory.data()[2 * memory.size() - 1] = 43;
+  EXPECT_EQ(memory.data()[memory.size() - 1], 43);
+}
+
+TEST_F(MirroredAtomicBufferFixture, MoveTransfersMapping) {
+  const MirroredMemory::pointer_type data = memory.data();
+  MirroredMemory other(std::move(memory));
+  EXPECT_EQ(other.data(), data);
+  EXPECT_EQ(memory.data(), nullptr);
+  EXPECT_EQ(memory.size(), 0);
+
+  ringBuffer.init(other.data(), other.size());
+  EXPECT_EQ(ringBuffer.allocate(10, false).ptr, data);
+}
+
+TEST_F(MirroredAtomicBufferFixture, AllocateAcrossEnd) {
+  advanceToEnd();
+
+  Mem mem = ringBuffer.allocate(20, false);
+  ASSERT_EQ(mem.len, 20);
+  EXPECT_EQ(mem.ptr, memory.data() + memory.size() - kTail);
+  memset(mem.ptr, 0xAB, mem.len);
+  EXPECT_EQ(ringBuffer.publish(mem), 20);
+  EXPECT_EQ(ringBuffer.size(), 20);
+
+  // The bytes after the wrap-around point have been written through the mirror.
+  EXPECT_EQ(memory.data()[0], 0xAB);
+  EXPECT_EQ(memory.data()[20 - kTail - 1], 0xAB);
+
+  Mem data = ringBuffer.peek(20, false);
+  EXPECT_EQ(data, mem);
+  EXPECT_EQ(ringBuffer.consume(data), 20);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(MirroredAtomicBufferFixture, AllocateWholeBuffer) {
+  advanceToEnd();
+
+  Mem mem = ringBuffer.allocate(memory.size(), false);
+  EXPECT_EQ(mem.len, memory.size());
+  EXPECT_EQ(ringBuffer.allocate(1, true), Mem());
+  EXPECT_EQ(ringBuffer.publish(mem), memory.size());
+  EXPECT_EQ(ringBuffer.peek(memory.size(), false), mem);
+}
+
+TEST_F(MirroredAtomicBufferFixture, AllocateIsLimitedByFreeSpace) {
+  Mem first = ringBuffer.allocate(memory.size() - 10, false);
+  ASSERT_EQ(ringBuffer.publish(first), first.len);
+
+  EXPECT_EQ(ringBuffer.allocate(11, false), Mem());
+  Mem mem = ringBuffer.allocate(11, true);
+  EXPECT_EQ(mem.len, 10);
+
+  // Data that has not been published cannot be peeked.
+  EXPECT_EQ(ringBuffer.peek(memory.size(), false), Mem());
+  EXPECT_EQ(ringBuffer.peek(memory.size(), true), first);
+}
+
+struct MirroredMultiProducerTraits : public MirroredTraits {
+  using Synchronization = MultiProducerSynchronization;
+};
+
+TEST_F(MirroredAtomicBufferFixture, MultiProducerOutOfOrderAcrossEnd) {
+  using Buffer = BasicAtomicRingBuffer<MirroredMultiProducerTraits>;
+  std::vector<Buffer::completion_word_type> completionMap(Buffer::completionMapSize(memory.size()));
+  Buffer buffer;
+  buffer.init(memory.data(), memory.size(), completionMap.data());
+
+  Buffer::MemoryRange mem = buffer.allocate(memory.size() - kTail, false);
+  ASSERT_EQ(buffer.publish(mem), mem.len);
+  ASSERT_EQ(buffer.consume(buffer.peek(mem.len, false)), mem.len);
+
+  Buffer::MemoryRange first = buffer.allocate(2 * kTail, false);
+  Buffer::MemoryRange second = buffer.allocate(3, false);
+  ASSERT_EQ(first.len, 2 * kTail);
+  EXPECT_EQ(second.ptr, memory.data() + kTail);
+
+  EXPECT_EQ(buffer.publish(second), 3);
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(buffer.publish(first), 2 * kTail);
+
+  Buffer::MemoryRange data = buffer.peek(2 * kTail + 3, false);
+  EXPECT_EQ(data.ptr, first.ptr);
+  EXPECT_EQ(buffer.consume(data), 2 * kTail + 3);
+
+  // All completion bits have been cleared again.
+  mem = buffer.allocate(memory.size(), false);
+  EXPECT_EQ(buffer.publish(mem), memory.size());
+  EXPECT_EQ(buffer.size(), memory.size());
+}
+
+}  // namespace AtomicRingBuffer
+
+#endif  // __linux__
@@ -1,8 +0,0 @@
-#include "Mocks.h"
-
-namespace AtomicRingBuffer {
-
-const AtomicRingBuffer::size_type NoBufferAtomicBufferFixture::kBufferSize;
-const AtomicRingBuffer::size_type FilledAtomicBufferFixture::kInitialFill;
-
-}  // namespace AtomicRingBuffer
@@ -11,63 +11,89 @@
 
 namespace AtomicRingBuffer {
 
+/**
+ * \brief Buffer types that run the generic ring buffer tests.
+ *
+ * Each traits configuration has to behave like the default buffer for in-order use, so the fixtures below are typed
+ * over this list. Tests of behaviour that only a single policy has stay in that policy's own test file.
+ */
+using AtomicRingBufferTypes = ::testing::Types<AtomicRingBuffer, CacheAlignedAtomicRingBuffer,
+                                               CachedIndexAtomicRingBuffer, SpscAtomicRingBuffer,
+                                               MultiProducerAtomicRingBuffer>;
+
+template <typename Buffer>
 class NoBufferAtomicBufferFixture : public ::testing::Test {
  public:
-  using Mem = AtomicRingBuffer::MemoryRange;
+  using Mem = typename Buffer::MemoryRange;
 
   // void SetUp() {}
 
   // void TearDown() {}
 
-  AtomicRingBuffer ringBuffer;
+  Buffer ringBuffer;
 
-  constexpr static const AtomicRingBuffer::size_type kBufferSize = 10;
+  constexpr static const typename Buffer::size_type kBufferSize = 10;
   uint8_t buffer[kBufferSize];
+  typename Buffer::completion_word_type completionMap[Buffer::completionMapSize(kBufferSize)];
 };
 
-class BufferedAtomicBufferFixture : public NoBufferAtomicBufferFixture {
+template <typename Buffer>
+constexpr const typename Buffer::size_type NoBufferAtomicBufferFixture<Buffer>::kBufferSize;
+
+template <typename Buffer>
+class BufferedAtomicBufferFixture : public NoBufferAtomicBufferFixture<Buffer> {
  public:
   void SetUp() {
-    memset(buffer, 0xFF, kBufferSize);
-    ringBuffer.init(buffer, kBufferSize);
+    memset(this->buffer, 0xFF, this->kBufferSize);
+    this->ringBuffer.init(this->buffer, this->kBufferSize, this->completionMap);
 
-    EXPECT_EQ(ringBuffer.size(), 0);
-    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    EXPECT_EQ(this->ringBuffer.capacity(), this->kBufferSize);
   }
 
   // void TearDown() {}
 };
 
-class FilledAtomicBufferFixture : public BufferedAtomicBufferFixture {
+template <typename Buffer>
+class FilledAtomicBufferFixture : public BufferedAtomicBufferFixture<Buffer> {
  public:
+  using Mem = typename Buffer::MemoryRange;
+
   void SetUp() {
-    BufferedAtomicBufferFixture::SetUp();
-    Mem mem = ringBuffer.allocate(kInitialFill, false);
+    BufferedAtomicBufferFixture<Buffer>::SetUp();
+    Mem mem = this->ringBuffer.allocate(kInitialFill, false);
     ASSERT_EQ(mem.len, kInitialFill);
     ASSERT_NE(mem.ptr, nullptr);
 
-    for (AtomicRingBuffer::size_type i = 0; i < kInitialFill; ++i) {
-      mem.ptr[i] = static_cast<AtomicRingBuffer::value_type>(i);
+    for (typename Buffer::size_type i = 0; i < kInitialFill; ++i) {
+      mem.ptr[i] = static_cast<typename Buffer::value_type>(i);
     }
 
-    ASSERT_EQ(ringBuffer.publish(mem), kInitialFill);
-    ASSERT_EQ(ringBuffer.size(), kInitialFill);
+    ASSERT_EQ(this->ringBuffer.publish(mem), kInitialFill);
+    ASSERT_EQ(this->ringBuffer.size(), kInitialFill);
   }
 
   // Read some bytes from the start of the buffer
   void consume5BytesAtStart() {
-    Mem mem = ringBuffer.peek(5, false);
+    Mem mem = this->ringBuffer.peek(5, false);
 
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
+    EXPECT_EQ(mem.ptr, this->buffer);
 
-    ASSERT_EQ(ringBuffer.consume(mem), 5);
-    ASSERT_EQ(ringBuffer.size(), 2);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 5);
+    ASSERT_EQ(this->ringBuffer.size(), 2);
   }
 
-  constexpr static const AtomicRingBuffer::size_type kInitialFill = 7;
+  constexpr static const typename Buffer::size_type kInitialFill = 7;
 };
 
+template <typename Buffer>
+constexpr const typename Buffer::size_type FilledAtomicBufferFixture<Buffer>::kInitialFill;
+
+TYPED_TEST_SUITE(NoBufferAtomicBufferFixture, AtomicRingBufferTypes);
+TYPED_TEST_SUITE(BufferedAtomicBufferFixture, AtomicRingBufferTypes);
+TYPED_TEST_SUITE(FilledAtomicBufferFixture, AtomicRingBufferTypes);
+
 struct MyStruct {
   float f;
   uint16_t i;
@@ -0,0 +1,169 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AtomicRingBuffer/MpmcObjectRingBuffer.h"
+#include "Mocks.h"
+
+namespace AtomicRingBuffer {
+
+class MpmcObjectRingBufferFixture : public ::testing::Test {
+ public:
+  constexpr static const std::size_t kBufferCapacity = 4;
+
+  using StructBuffer_t = MpmcObjectRingBuffer<MyStruct, kBufferCapacity>;
+
+  StructBuffer_t structBuffer;
+};
+
+const std::size_t MpmcObjectRingBufferFixture::kBufferCapacity;
+
+TEST_F(MpmcObjectRingBufferFixture, NewBufferIsEmpty) {
+  EXPECT_TRUE(structBuffer.empty());
+  EXPECT_EQ(structBuffer.capacity(), kBufferCapacity);
+  EXPECT_EQ(structBuffer.peek(), StructBuffer_t::MemoryRange{});
+}
+
+TEST_F(MpmcObjectRingBufferFixture, AllocatedElementIsNotVisible) {
+  auto mem = structBuffer.allocate();
+  EXPECT_NE(mem.ptr, nullptr);
+  EXPECT_EQ(mem.len, 1);
+  EXPECT_EQ(structBuffer.peek(), StructBuffer_t::MemoryRange{});
+}
+
+TEST_F(MpmcObjectRingBufferFixture, PublishConsumeInOrder) {
+  std::array<MyStruct, 4> elems = {demoElems[0], demoElems[1], demoElems[2], demoElems[3]};
+
+  publishElements(structBuffer, elems);
+  EXPECT_EQ(structBuffer.size(), 4);
+  consumeElements(structBuffer, elems);
+  EXPECT_TRUE(structBuffer.empty());
+}
+
+TEST_F(MpmcObjectRingBufferFixture, FullBufferRejectsAllocate) {
+  for (std::size_t i = 0; i < kBufferCapacity; ++i) {
+    EXPECT_EQ(structBuffer.allocate().len, 1);
+  }
+  EXPECT_EQ(structBuffer.allocate(), StructBuffer_t::MemoryRange{});
+}
+
+TEST_F(MpmcObjectRingBufferFixture, PeekClaimsDistinctElements) {
+  std::array<MyStruct, 2> elems = {demoElems[0], demoElems[1]};
+  publishElements(structBuffer, elems);
+
+  auto first = structBuffer.peek();
+  auto second = structBuffer.peek();
+  ASSERT_EQ(first.len, 1);
+  ASSERT_EQ(second.len, 1);
+  EXPECT_EQ(*first.ptr, demoElems[0]);
+  EXPECT_EQ(*second.ptr, demoElems[1]);
+
+  // Consumers may finish in any order.
+  EXPECT_EQ(structBuffer.consume(second), 1);
+  EXPECT_EQ(structBuffer.consume(first), 1);
+}
+
+TEST_F(MpmcObjectRingBufferFixture, RejectForeignPointer) {
+  MyStruct elem;
+  EXPECT_EQ(structBuffer.publish(StructBuffer_t::MemoryRange{&elem, 1}), 0);
+  EXPECT_EQ(structBuffer.consume(StructBuffer_t::MemoryRange{nullptr, 1}), 0);
+}
+
+TEST_F(MpmcObjectRingBufferFixture, RejectDoublePublish) {
+  auto mem = structBuffer.allocate();
+  ASSERT_EQ(structBuffer.publish(mem), 1);
+  EXPECT_EQ(structBuffer.publish(mem), 0);
+  EXPECT_EQ(structBuffer.size(), 1);
+
+  EXPECT_EQ(structBuffer.peek(), mem);
+  EXPECT_EQ(structBuffer.peek(), StructBuffer_t::MemoryRange{});
+}
+
+TEST_F(MpmcObjectRingBufferFixture, RejectPublishOfFreeSlot) {
+  auto mem = structBuffer.allocate();
+  ASSERT_EQ(structBuffer.publish(mem), 1);
+  ASSERT_EQ(structBuffer.peek(), mem);
+  ASSERT_EQ(structBuffer.consume(mem), 1);
+
+  // The slot is free again, but not allocated.
+  EXPECT_EQ(structBuffer.publish(mem), 0);
+  EXPECT_EQ(structBuffer.peek(), StructBuffer_t::MemoryRange{});
+  EXPECT_TRUE(structBuffer.empty());
+}
+
+TEST_F(MpmcObjectRingBufferFixture, RejectDoubleConsume) {
+  std::array<MyStruct, 2> elems = {demoElems[0], demoElems[1]};
+  publishElements(structBuffer, elems);
+
+  auto first = structBuffer.peek();
+  ASSERT_EQ(first.len, 1);
+  ASSERT_EQ(structBuffer.consume(first), 1);
+  EXPECT_EQ(structBuffer.consume(first), 0);
+
+  // The second element is still readable once.
+  auto second = structBuffer.peek();
+  ASSERT_EQ(second.len, 1);
+  EXPECT_EQ(*second.ptr, demoElems[1]);
+  EXPECT_EQ(structBuffer.consume(second), 1);
+  EXPECT_EQ(structBuffer.peek(), StructBuffer_t::MemoryRange{});
+}
+
+TEST_F(MpmcObjectRingBufferFixture, RejectConsumeOfUnpeekedElement) {
+  auto mem = structBuffer.allocate();
+  ASSERT_EQ(structBuffer.publish(mem), 1);
+  EXPECT_EQ(structBuffer.consume(mem), 0);
+
+  auto peeked = structBuffer.peek();
+  EXPECT_EQ(peeked, mem);
+  EXPECT_EQ(structBuffer.consume(peeked), 1);
+}
+
+TEST(MpmcObjectRingBuffer, MultipleConsumersReceiveEachElementOnce) {
+  constexpr std::size_t kNumConsumers = 3;
+  constexpr uint32_t kNumElements = 20000;
+
+  MpmcObjectRingBuffer<uint32_t, 16> buffer;
+  std::vector<std::atomic<uint8_t>> received(kNumElements);
+  std::atomic<uint32_t> numReceived{0};
+
+  std::vector<std::thread> consumers;
+  for (std::size_t i = 0; i < kNumConsumers; ++i) {
+    consumers.emplace_back([&]() {
+      while (numReceived.load() < kNumElements) {
+        auto mem = buffer.peek();
+        if (mem.len == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        received[*mem.ptr].fetch_add(1);
+        buffer.consume(mem);
+        numReceived.fetch_add(1);
+      }
+    });
+  }
+
+  for (uint32_t value = 0; value < kNumElements; ++value) {
+    decltype(buffer)::MemoryRange mem;
+    while ((mem = buffer.allocate()).len == 0) {
+      std::this_thread::yield();
+    }
+    *mem.ptr = value;
+    buffer.publish(mem);
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  bool allOnce = true;
+  for (auto& count : received) {
+    allOnce &= (count.load() == 1);
+  }
+  EXPECT_TRUE(allOnce);
+  EXPECT_TRUE(buffer.empty());
+}
+
+}  // namespace AtomicRingBuffer
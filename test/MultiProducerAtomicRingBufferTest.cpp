@@ -0,0 +1,187 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+static_assert(!std::is_constructible<MultiProducerAtomicRingBuffer, uint8_t *, std::size_t>::value,
+              "Multiple producers require a completion map.");
+static_assert(std::is_constructible<SpscAtomicRingBuffer, uint8_t *, std::size_t>::value,
+              "A single producer needs no completion map.");
+
+class MultiProducerAtomicBufferFixture : public ::testing::Test {
+ public:
+  using Mem = MultiProducerAtomicRingBuffer::MemoryRange;
+
+  void SetUp() {
+    memset(buffer, 0xFF, kBufferSize);
+    ringBuffer.init(buffer, kBufferSize, completionMap);
+  }
+
+  constexpr static const MultiProducerAtomicRingBuffer::size_type kBufferSize = 40;
+  uint8_t buffer[kBufferSize];
+  MultiProducerAtomicRingBuffer::completion_word_type
+      completionMap[MultiProducerAtomicRingBuffer::completionMapSize(kBufferSize)];
+
+  MultiProducerAtomicRingBuffer ringBuffer;
+};
+
+const MultiProducerAtomicRingBuffer::size_type MultiProducerAtomicBufferFixture::kBufferSize;
+
+TEST_F(MultiProducerAtomicBufferFixture, CompletionMapSize) {
+  EXPECT_EQ(MultiProducerAtomicRingBuffer::completionMapSize(1), 1);
+  EXPECT_EQ(MultiProducerAtomicRingBuffer::completionMapSize(32), 1);
+  EXPECT_EQ(MultiProducerAtomicRingBuffer::completionMapSize(33), 2);
+}
+
+TEST_F(MultiProducerAtomicBufferFixture, ConstructWithCompletionMap) {
+  MultiProducerAtomicRingBuffer constructed(buffer, kBufferSize, completionMap);
+  Mem first = constructed.allocate(5, false);
+  Mem second = constructed.allocate(5, false);
+  EXPECT_EQ(constructed.publish(second), 5);
+  EXPECT_EQ(constructed.publish(first), 5);
+  EXPECT_EQ(constructed.size(), 10);
+}
+
+TEST_F(MultiProducerAtomicBufferFixture, OutOfOrderPublish) {
+  Mem first = ringBuffer.allocate(5, false);
+  Mem second = ringBuffer.allocate(7, false);
+  Mem third = ringBuffer.allocate(3, false);
+  ASSERT_EQ(second.ptr, first.ptr + 5);
+  ASSERT_EQ(third.ptr, second.ptr + 7);
+
+  EXPECT_EQ(ringBuffer.publish(third), 3);
+  EXPECT_EQ(ringBuffer.size(), 0);
+  EXPECT_EQ(ringBuffer.publish(second), 7);
+  EXPECT_EQ(ringBuffer.size(), 0);
+
+  // Publishing the first allocation makes everything visible at once.
+  EXPECT_EQ(ringBuffer.publish(first), 5);
+  EXPECT_EQ(ringBuffer.size(), 15);
+
+  Mem mem = ringBuffer.peek(15, false);
+  EXPECT_EQ(mem.ptr, first.ptr);
+  EXPECT_EQ(ringBuffer.consume(mem), 15);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(MultiProducerAtomicBufferFixture, RejectUnallocatedPublish) {
+  Mem mem = ringBuffer.allocate(5, false);
+  EXPECT_EQ(ringBuffer.publish(Mem{mem.ptr + 5, 2}), 0);
+  EXPECT_EQ(ringBuffer.publish(Mem{nullptr, 2}), 0);
+
+  // Publish is limited to the allocated range.
+  mem.len = 10;
+  EXPECT_EQ(ringBuffer.publish(mem), 5);
+  EXPECT_EQ(ringBuffer.size(), 5);
+}
+
+TEST_F(MultiProducerAtomicBufferFixture, ConsumedBytesAreReusable) {
+  for (int round = 0; round < 10; ++round) {
+    Mem first = ringBuffer.allocate(13, true);
+    Mem second = ringBuffer.allocate(13, true);
+    ASSERT_NE(first.len, 0);
+    ASSERT_NE(second.len, 0);
+
+    EXPECT_EQ(ringBuffer.publish(second), second.len);
+    EXPECT_EQ(ringBuffer.size(), 0);
+    EXPECT_EQ(ringBuffer.publish(first), first.len);
+    EXPECT_EQ(ringBuffer.size(), first.len + second.len);
+
+    while (!ringBuffer.empty()) {
+      Mem mem = ringBuffer.peek(kBufferSize, true);
+      ASSERT_EQ(ringBuffer.consume(mem), mem.len);
+    }
+  }
+}
+
+TEST_F(MultiProducerAtomicBufferFixture, SegmentsAcrossBufferEnd) {
+  Mem mem = ringBuffer.allocate(30, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 30);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(30, false)), 30);
+
+  MultiProducerAtomicRingBuffer::MemoryRangePair first = ringBuffer.allocateSegments(15, false);
+  Mem second = ringBuffer.allocate(5, false);
+  EXPECT_EQ(first.first, (Mem{buffer + 30, 10}));
+  EXPECT_EQ(first.second, (Mem{buffer, 5}));
+  EXPECT_EQ(second.ptr, buffer + 5);
+
+  EXPECT_EQ(ringBuffer.publish(second), 5);
+  EXPECT_EQ(ringBuffer.size(), 0);
+  EXPECT_EQ(ringBuffer.publish(first), 15);
+  EXPECT_EQ(ringBuffer.size(), 20);
+
+  MultiProducerAtomicRingBuffer::MemoryRangePair data = ringBuffer.peekSegments(20, false);
+  EXPECT_EQ(data.first, first.first);
+  EXPECT_EQ(data.second, (Mem{buffer, 10}));
+  EXPECT_EQ(ringBuffer.consume(data), 20);
+  EXPECT_TRUE(ringBuffer.empty());
+
+  // The completion bits of both segments have been cleared, so the space can be reused.
+  mem = ringBuffer.allocate(40, true);
+  EXPECT_EQ(mem.len, 30);
+  EXPECT_EQ(ringBuffer.publish(mem), 30);
+}
+
+TEST(MultiProducerAtomicBuffer, ConcurrentProducers) {
+  constexpr std::size_t kNumProducers = 4;
+  constexpr std::size_t kRecordsPerProducer = 5000;
+  constexpr std::size_t kRecordSize = 4;
+  constexpr std::size_t kBufferSize = 16 * kRecordSize;
+
+  uint8_t buffer[kBufferSize];
+  MultiProducerAtomicRingBuffer::completion_word_type
+      completionMap[MultiProducerAtomicRingBuffer::completionMapSize(kBufferSize)];
+  MultiProducerAtomicRingBuffer ringBuffer;
+  ringBuffer.init(buffer, kBufferSize, completionMap);
+
+  std::vector<std::thread> producers;
+  for (std::size_t producerId = 0; producerId < kNumProducers; ++producerId) {
+    producers.emplace_back([&ringBuffer, producerId]() {
+      for (std::size_t seq = 0; seq < kRecordsPerProducer; ++seq) {
+        MultiProducerAtomicRingBuffer::MemoryRange mem;
+        while ((mem = ringBuffer.allocate(kRecordSize, false)).len == 0) {
+          std::this_thread::yield();
+        }
+        mem.ptr[0] = static_cast<uint8_t>(producerId);
+        mem.ptr[1] = static_cast<uint8_t>(seq);
+        mem.ptr[2] = static_cast<uint8_t>(seq >> 8);
+        mem.ptr[3] = static_cast<uint8_t>(mem.ptr[0] ^ mem.ptr[1] ^ mem.ptr[2]);
+        ringBuffer.publish(mem);
+      }
+    });
+  }
+
+  std::array<std::size_t, kNumProducers> nextSeq{};
+  bool valid = true;
+  for (std::size_t received = 0; received < kNumProducers * kRecordsPerProducer; ++received) {
+    MultiProducerAtomicRingBuffer::MemoryRange mem;
+    while ((mem = ringBuffer.peek(kRecordSize, false)).len == 0) {
+      std::this_thread::yield();
+    }
+    const std::size_t producerId = mem.ptr[0];
+    const std::size_t seq = mem.ptr[1] | (mem.ptr[2] << 8);
+    valid &= (producerId < kNumProducers) && (mem.ptr[3] == (mem.ptr[0] ^ mem.ptr[1] ^ mem.ptr[2]));
+    if (valid) {
+      valid &= (seq == nextSeq[producerId]);
+      ++nextSeq[producerId];
+    }
+    ringBuffer.consume(mem);
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+}  // namespace AtomicRingBuffer
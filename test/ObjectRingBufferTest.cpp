@@ -1,6 +1,10 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+
 #include "AtomicRingBuffer/ObjectRingBuffer.h"
 #include "Mocks.h"
 
@@ -129,4 +133,247 @@ TEST_F(ObjectRingBufferFixture, AfterTwoPublish_ConsumeTwo_PeekRejected) {
   EXPECT_EQ(mem.len, 0);
 }
 
-}  // namespace AtomicRingBuffer
\ No newline at end of file
+TEST_F(ObjectRingBufferFixture, BatchAllocate) {
+  auto mem = structBuffer.allocate(2, false);
+  EXPECT_NE(mem.ptr, nullptr);
+  EXPECT_EQ(mem.len, 2);
+
+  EXPECT_EQ(structBuffer.allocate(2, false), StructBuffer_t::MemoryRange{});
+
+  auto rest = structBuffer.allocate(2, true);
+  EXPECT_EQ(rest.ptr, mem.ptr + 2);
+  EXPECT_EQ(rest.len, 1);
+}
+
+TEST_F(ObjectRingBufferFixture, BatchPublish_BatchPeek) {
+  auto mem = structBuffer.allocate(3, false);
+  ASSERT_EQ(mem.len, 3);
+  memcpy(mem.ptr, demoElems, 3 * sizeof(MyStruct));
+  EXPECT_EQ(structBuffer.publish(mem), 3);
+  EXPECT_EQ(structBuffer.size(), 3);
+
+  EXPECT_EQ(structBuffer.peek(4, false), StructBuffer_t::MemoryRange{});
+
+  auto peek = structBuffer.peek(4, true);
+  ASSERT_EQ(peek.len, 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(peek.ptr[i], demoElems[i]) << "Elem Nr. " << i;
+  }
+  EXPECT_EQ(structBuffer.consume(peek), 3);
+  EXPECT_TRUE(structBuffer.empty());
+}
+
+TEST_F(ObjectRingBufferFixture, Segments_Wraparound) {
+  {
+    std::array<MyStruct, 2> elems = {demoElems[0], demoElems[1]};
+    publishElements(structBuffer, elems);
+    consumeElements(structBuffer, elems);
+  }
+
+  // One element remains until the end of the buffer, two more are at the beginning.
+  auto ranges = structBuffer.allocateSegments(3);
+  ASSERT_EQ(ranges.first.len, 1);
+  ASSERT_EQ(ranges.second.len, 2);
+  EXPECT_EQ(ranges.second.ptr + 2, ranges.first.ptr);
+  EXPECT_EQ(ranges.len(), 3);
+
+  ranges.first.ptr[0] = demoElems[1];
+  ranges.second.ptr[0] = demoElems[2];
+  ranges.second.ptr[1] = demoElems[3];
+  EXPECT_EQ(structBuffer.publish(ranges), 3);
+  EXPECT_EQ(structBuffer.size(), 3);
+
+  auto peeked = structBuffer.peekSegments(5);
+  EXPECT_EQ(peeked, ranges);
+  EXPECT_EQ(*peeked.first.ptr, demoElems[1]);
+  EXPECT_EQ(peeked.second.ptr[0], demoElems[2]);
+  EXPECT_EQ(peeked.second.ptr[1], demoElems[3]);
+
+  EXPECT_EQ(structBuffer.consume(peeked), 3);
+  EXPECT_TRUE(structBuffer.empty());
+}
+
+TEST_F(ObjectRingBufferFixture, Segments_NoWraparound) {
+  auto ranges = structBuffer.allocateSegments(2);
+  EXPECT_EQ(ranges.first.len, 2);
+  EXPECT_EQ(ranges.second, StructBuffer_t::MemoryRange{});
+  EXPECT_EQ(structBuffer.publish(ranges), 2);
+
+  auto peeked = structBuffer.peekSegments(3);
+  EXPECT_EQ(peeked, ranges);
+}
+
+TEST_F(ObjectRingBufferFixture, PushPop) {
+  EXPECT_TRUE(structBuffer.push(demoElems[0]));
+  EXPECT_TRUE(structBuffer.emplace(demoElems[1]));
+  EXPECT_EQ(structBuffer.size(), 2);
+  EXPECT_EQ(*structBuffer.front(), demoElems[0]);
+
+  MyStruct popped;
+  EXPECT_TRUE(structBuffer.pop(popped));
+  EXPECT_EQ(popped, demoElems[0]);
+  EXPECT_EQ(*structBuffer.front(), demoElems[1]);
+  EXPECT_TRUE(structBuffer.pop());
+  EXPECT_EQ(structBuffer.front(), nullptr);
+  EXPECT_FALSE(structBuffer.pop());
+}
+
+TEST_F(ObjectRingBufferFixture, PushRejectedWhenFull) {
+  for (std::size_t i = 0; i < kBufferCapacity; ++i) {
+    EXPECT_TRUE(structBuffer.push(demoElems[i]));
+  }
+  EXPECT_FALSE(structBuffer.push(demoElems[3]));
+  EXPECT_EQ(structBuffer.size(), structBuffer.capacity());
+}
+
+TEST_F(ObjectRingBufferFixture, BulkPushPop_Wraparound) {
+  ASSERT_TRUE(structBuffer.push(demoElems[0]));
+  ASSERT_TRUE(structBuffer.pop());
+
+  // Only three of the four elements fit. They wrap around the end of the buffer.
+  EXPECT_EQ(structBuffer.push(demoElems, 4), 3);
+  EXPECT_EQ(structBuffer.size(), 3);
+
+  MyStruct popped[4];
+  EXPECT_EQ(structBuffer.pop(popped, 4), 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(popped[i], demoElems[i]) << "Elem Nr. " << i;
+  }
+  EXPECT_TRUE(structBuffer.empty());
+  EXPECT_EQ(structBuffer.pop(popped, 4), 0);
+}
+
+namespace {
+
+/**
+ * \brief Counts how many instances are alive.
+ */
+struct Tracked {
+  static int numAlive;
+
+  explicit Tracked(const int val) : value(val) { ++numAlive; }
+  Tracked(const Tracked& other) : value(other.value) { ++numAlive; }
+  Tracked& operator=(const Tracked&) = default;
+  ~Tracked() { --numAlive; }
+
+  int value;
+};
+
+int Tracked::numAlive = 0;
+
+/**
+ * \brief Throws when constructed from a negative value or copied from an instance marked with throwOnCopy.
+ */
+struct Fragile {
+  explicit Fragile(const int val, const bool throws = false) : value(val), throwOnCopy(throws) {
+    if (val < 0) {
+      throw std::invalid_argument("negative");
+    }
+  }
+  Fragile(const Fragile& other) : value(other.value), throwOnCopy(false) {
+    if (other.throwOnCopy) {
+      throw std::runtime_error("copy");
+    }
+  }
+  Fragile& operator=(const Fragile&) = default;
+
+  int value;
+  bool throwOnCopy;
+};
+
+}  // namespace
+
+TEST(ObjectRingBufferObjects, EmplaceConstructsPopDestroys) {
+  ObjectRingBuffer<Tracked, 4> objectBuffer;
+  EXPECT_EQ(Tracked::numAlive, 0);
+
+  EXPECT_TRUE(objectBuffer.emplace(1));
+  EXPECT_TRUE(objectBuffer.push(Tracked(2)));
+  EXPECT_EQ(Tracked::numAlive, 2);
+  EXPECT_EQ(objectBuffer.front()->value, 1);
+
+  EXPECT_TRUE(objectBuffer.pop());
+  EXPECT_EQ(Tracked::numAlive, 1);
+
+  const Tracked values[] = {Tracked(3), Tracked(4), Tracked(5)};
+  EXPECT_EQ(objectBuffer.push(values, 3), 3);
+  EXPECT_EQ(Tracked::numAlive, 7);
+
+  Tracked popped[] = {Tracked(0), Tracked(0), Tracked(0), Tracked(0)};
+  EXPECT_EQ(objectBuffer.pop(popped, 4), 4);
+  EXPECT_EQ(popped[0].value, 2);
+  EXPECT_EQ(popped[3].value, 5);
+  EXPECT_EQ(Tracked::numAlive, 7);
+  EXPECT_TRUE(objectBuffer.empty());
+}
+
+TEST(ObjectRingBufferObjects, MoveOnly) {
+  ObjectRingBuffer<std::unique_ptr<std::string>, 2> objectBuffer;
+  EXPECT_TRUE(objectBuffer.push(std::unique_ptr<std::string>(new std::string("moved"))));
+  EXPECT_TRUE(objectBuffer.emplace(new std::string("emplaced")));
+
+  std::unique_ptr<std::string> popped;
+  EXPECT_TRUE(objectBuffer.pop(popped));
+  EXPECT_EQ(*popped, "moved");
+  EXPECT_EQ(**objectBuffer.front(), "emplaced");
+  EXPECT_TRUE(objectBuffer.pop(popped));
+  EXPECT_EQ(*popped, "emplaced");
+  EXPECT_TRUE(objectBuffer.empty());
+}
+
+TEST(ObjectRingBufferObjects, DestructorDestroysRemainingElements) {
+  {
+    ObjectRingBuffer<Tracked, 4> objectBuffer;
+    EXPECT_TRUE(objectBuffer.emplace(1));
+    EXPECT_TRUE(objectBuffer.emplace(2));
+    EXPECT_EQ(Tracked::numAlive, 2);
+  }
+  EXPECT_EQ(Tracked::numAlive, 0);
+
+  {
+    DynamicObjectRingBuffer<Tracked> objectBuffer(4);
+    EXPECT_TRUE(objectBuffer.emplace(1));
+    EXPECT_EQ(Tracked::numAlive, 1);
+  }
+  EXPECT_EQ(Tracked::numAlive, 0);
+}
+
+TEST(ObjectRingBufferObjects, ThrowingConstructorReturnsSpace) {
+  ObjectRingBuffer<Fragile, 2> objectBuffer;
+  EXPECT_TRUE(objectBuffer.emplace(1));
+  EXPECT_THROW(objectBuffer.emplace(-1), std::invalid_argument);
+  EXPECT_EQ(objectBuffer.size(), 1);
+
+  // The failed slot neither blocks later elements nor shows up as an element.
+  EXPECT_TRUE(objectBuffer.emplace(2));
+  EXPECT_EQ(objectBuffer.size(), 2);
+  EXPECT_EQ(objectBuffer.front()->value, 1);
+  EXPECT_TRUE(objectBuffer.pop());
+  EXPECT_EQ(objectBuffer.front()->value, 2);
+  EXPECT_TRUE(objectBuffer.pop());
+  EXPECT_TRUE(objectBuffer.empty());
+}
+
+TEST(ObjectRingBufferObjects, ThrowingCopyPublishesCopiedElements) {
+  ObjectRingBuffer<Fragile, 4> objectBuffer;
+  // Wrap around, so that the copy fails in the second segment.
+  EXPECT_TRUE(objectBuffer.emplace(0));
+  EXPECT_TRUE(objectBuffer.emplace(0));
+  EXPECT_TRUE(objectBuffer.pop());
+  EXPECT_TRUE(objectBuffer.pop());
+
+  const Fragile values[] = {Fragile(1), Fragile(2), Fragile(3), Fragile(4, true)};
+  EXPECT_THROW(objectBuffer.push(values, 4), std::runtime_error);
+  EXPECT_EQ(objectBuffer.size(), 3);
+
+  // A failure in the first segment returns the second segment as well.
+  Fragile popped[] = {Fragile(0), Fragile(0), Fragile(0)};
+  EXPECT_EQ(objectBuffer.pop(popped, 3), 3);
+  EXPECT_EQ(popped[2].value, 3);
+  EXPECT_THROW(objectBuffer.push(values + 1, 3), std::runtime_error);
+  EXPECT_EQ(objectBuffer.size(), 2);
+  EXPECT_EQ(objectBuffer.push(values, 2), 2);
+  EXPECT_EQ(objectBuffer.size(), 4);
+}
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,81 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include "Mocks.h"
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/StaticAtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+namespace {
+
+constexpr std::size_t kTransferSize = 100000;
+
+/*
+ * Transfer a sequence of bytes from a producer thread to a consumer thread and check that it arrives in order.
+ */
+template <typename BufferT>
+void transferSequence(BufferT& ringBuffer) {
+  std::thread producer([&ringBuffer]() {
+    std::size_t sent = 0;
+    while (sent < kTransferSize) {
+      auto mem = ringBuffer.allocate(kTransferSize - sent, true);
+      for (std::size_t i = 0; i < mem.len; ++i) {
+        mem.ptr[i] = static_cast<uint8_t>(sent + i);
+      }
+      sent += ringBuffer.publish(mem);
+      if (mem.len == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::size_t received = 0;
+  bool inOrder = true;
+  while (received < kTransferSize) {
+    auto mem = ringBuffer.peek(kTransferSize - received, true);
+    for (std::size_t i = 0; i < mem.len; ++i) {
+      inOrder &= (mem.ptr[i] == static_cast<uint8_t>(received + i));
+    }
+    received += ringBuffer.consume(mem);
+    if (mem.len == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(inOrder);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+}  // namespace
+
+using SpscAtomicBufferFixture = BufferedAtomicBufferFixture<SpscAtomicRingBuffer>;
+
+TEST_F(SpscAtomicBufferFixture, RejectOutOfOrder) {
+  Mem mem = ringBuffer.allocate(4, false);
+  ASSERT_EQ(mem.len, 4);
+
+  EXPECT_EQ(ringBuffer.publish(Mem{mem.ptr + 2, 2}), 0);
+  EXPECT_EQ(ringBuffer.publish(mem), 4);
+  EXPECT_EQ(ringBuffer.consume(Mem{mem.ptr + 2, 2}), 0);
+  EXPECT_EQ(ringBuffer.size(), 4);
+}
+
+TEST_F(SpscAtomicBufferFixture, TwoThreadTransfer) { transferSequence(ringBuffer); }
+
+TEST(SpscStaticAtomicBuffer, TwoThreadTransfer) {
+  StaticAtomicRingBuffer<16, SpscTraits> ringBuffer;
+  transferSequence(ringBuffer);
+}
+
+TEST(TolerantAtomicBuffer, TwoThreadTransfer) {
+  uint8_t buffer[16];
+  AtomicRingBuffer ringBuffer(buffer, sizeof(buffer));
+  transferSequence(ringBuffer);
+}
+
+}  // namespace AtomicRingBuffer
@@ -0,0 +1,130 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <limits>
+
+#include "AtomicRingBuffer/StaticAtomicRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+class StaticAtomicBufferFixture : public ::testing::Test {
+ public:
+  constexpr static const std::size_t kBufferSize = 8;
+
+  using RingBuffer_t = StaticAtomicRingBuffer<kBufferSize>;
+  using Mem = RingBuffer_t::MemoryRange;
+
+  void SetUp() {
+    EXPECT_EQ(ringBuffer.size(), 0);
+    EXPECT_EQ(ringBuffer.capacity(), kBufferSize);
+  }
+
+  RingBuffer_t ringBuffer;
+};
+
+const std::size_t StaticAtomicBufferFixture::kBufferSize;
+
+TEST_F(StaticAtomicBufferFixture, EmptyBuffer_Peek) {
+  EXPECT_EQ(ringBuffer.peek(1, true), Mem());
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(StaticAtomicBufferFixture, EmptyBuffer_Allocate_Oversize) {
+  EXPECT_EQ(ringBuffer.allocate(kBufferSize + 1, false), Mem());
+
+  Mem mem = ringBuffer.allocate(kBufferSize + 1, true);
+  EXPECT_EQ(mem.len, kBufferSize);
+  EXPECT_NE(mem.ptr, nullptr);
+}
+
+TEST_F(StaticAtomicBufferFixture, EmptyBuffer_Publish) {
+  Mem mem = ringBuffer.allocate(2, false);
+  mem.len = 5;
+  // Only allocated memory can be published.
+  EXPECT_EQ(ringBuffer.publish(mem), 2);
+
+  EXPECT_EQ(ringBuffer.publish(Mem{nullptr, 5}), 0);
+  EXPECT_EQ(ringBuffer.size(), 2);
+}
+
+TEST_F(StaticAtomicBufferFixture, FullCycle) {
+  Mem mem = ringBuffer.allocate(5, false);
+  ASSERT_EQ(mem.len, 5);
+  for (uint8_t i = 0; i < 5; ++i) {
+    mem.ptr[i] = i;
+  }
+  EXPECT_EQ(ringBuffer.size(), 0);
+  EXPECT_EQ(ringBuffer.publish(mem), 5);
+  EXPECT_EQ(ringBuffer.size(), 5);
+
+  Mem peeked = ringBuffer.peek(5, false);
+  EXPECT_EQ(peeked, mem);
+  for (uint8_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(peeked.ptr[i], i);
+  }
+  EXPECT_EQ(ringBuffer.consume(peeked), 5);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(StaticAtomicBufferFixture, RejectOutOfOrder) {
+  Mem mem = ringBuffer.allocate(4, false);
+  ASSERT_EQ(mem.len, 4);
+
+  Mem second{mem.ptr + 2, 2};
+  EXPECT_EQ(ringBuffer.publish(second), 0);
+  EXPECT_EQ(ringBuffer.publish(mem), 4);
+
+  EXPECT_EQ(ringBuffer.consume(second), 0);
+  EXPECT_EQ(ringBuffer.size(), 4);
+}
+
+TEST_F(StaticAtomicBufferFixture, Wraparound) {
+  Mem mem = ringBuffer.allocate(6, false);
+  ASSERT_EQ(ringBuffer.publish(mem), 6);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(4, false)), 4);
+
+  // Only two bytes remain until the end of the buffer.
+  EXPECT_EQ(ringBuffer.allocate(4, false), Mem());
+  Mem tail = ringBuffer.allocate(4, true);
+  EXPECT_EQ(tail.len, 2);
+  EXPECT_EQ(tail.ptr, mem.ptr + 6);
+  ASSERT_EQ(ringBuffer.publish(tail), 2);
+
+  Mem head = ringBuffer.allocate(4, false);
+  EXPECT_EQ(head.len, 4);
+  EXPECT_EQ(head.ptr, mem.ptr);
+  ASSERT_EQ(ringBuffer.publish(head), 4);
+
+  EXPECT_EQ(ringBuffer.size(), kBufferSize);
+  EXPECT_EQ(ringBuffer.allocate(1, true), Mem());
+
+  Mem peeked = ringBuffer.peek(std::numeric_limits<std::size_t>::max(), true);
+  EXPECT_EQ(peeked.len, 4);
+  ASSERT_EQ(ringBuffer.consume(peeked), 4);
+  peeked = ringBuffer.peek(std::numeric_limits<std::size_t>::max(), true);
+  EXPECT_EQ(peeked.len, 4);
+  EXPECT_EQ(peeked.ptr, mem.ptr);
+  ASSERT_EQ(ringBuffer.consume(peeked), 4);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST_F(StaticAtomicBufferFixture, ManyRounds) {
+  for (uint8_t round = 0; round < 100; ++round) {
+    Mem mem = ringBuffer.allocate(3, true);
+    ASSERT_NE(mem.len, 0);
+    for (std::size_t i = 0; i < mem.len; ++i) {
+      mem.ptr[i] = round;
+    }
+    ASSERT_EQ(ringBuffer.publish(mem), mem.len);
+
+    Mem peeked = ringBuffer.peek(3, true);
+    ASSERT_EQ(peeked, mem);
+    for (std::size_t i = 0; i < peeked.len; ++i) {
+      EXPECT_EQ(peeked.ptr[i], round);
+    }
+    ASSERT_EQ(ringBuffer.consume(peeked), peeked.len);
+  }
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+}  // namespace AtomicRingBuffer
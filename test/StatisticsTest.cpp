@@ -0,0 +1,270 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+static_assert(std::is_empty<detail::StatisticsCountersFor<DefaultTraits>>::value,
+              "Disabled statistics must not take space.");
+static_assert(std::is_empty<detail::OccupancyCountersFor<DefaultTraits>>::value,
+              "Disabled statistics must not take space.");
+
+struct CountingTraits : public DefaultTraits {
+  using Statistics = CountingStatistics;
+};
+
+struct OccupancyTraits : public SpscTraits {
+  using Statistics = OccupancyStatistics;
+};
+
+struct CachedOccupancyTraits : public CachedIndexTraits {
+  using Statistics = OccupancyStatistics;
+};
+
+struct CountingMultiProducerTraits : public MultiProducerTraits {
+  using Statistics = CountingStatistics;
+};
+
+class StatisticsFixture : public ::testing::Test {
+ public:
+  using Buffer_t = BasicAtomicRingBuffer<CountingTraits>;
+  using Mem = Buffer_t::MemoryRange;
+
+  void SetUp() { ringBuffer.init(buffer, kBufferSize); }
+
+  constexpr static const Buffer_t::size_type kBufferSize = 16;
+  uint8_t buffer[kBufferSize];
+
+  Buffer_t ringBuffer;
+};
+
+const StatisticsFixture::Buffer_t::size_type StatisticsFixture::kBufferSize;
+
+TEST_F(StatisticsFixture, NewBufferHasNoCounts) {
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.count, 0);
+  EXPECT_EQ(statistics.consume.bytes, 0);
+  EXPECT_EQ(statistics.highWaterMark, 0);
+}
+
+TEST_F(StatisticsFixture, CountsOperationsAndBytes) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(3, false)), 3);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(5, true)), 5);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.count, 2);
+  EXPECT_EQ(statistics.allocate.bytes, 7);
+  EXPECT_EQ(statistics.publish.count, 2);
+  EXPECT_EQ(statistics.publish.bytes, 7);
+  EXPECT_EQ(statistics.peek.count, 1);
+  EXPECT_EQ(statistics.peek.bytes, 5);
+  EXPECT_EQ(statistics.consume.count, 1);
+  EXPECT_EQ(statistics.consume.bytes, 5);
+  EXPECT_EQ(statistics.allocate.rejected, 0);
+  EXPECT_EQ(statistics.allocate.casFailures, 0);
+}
+
+TEST_F(StatisticsFixture, CountsSegments) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocateSegments(12, false)), 12);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peekSegments(12, false)), 12);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocateSegments(8, false)), 8);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.bytes, 20);
+  EXPECT_EQ(statistics.publish.bytes, 20);
+  EXPECT_EQ(statistics.peek.bytes, 12);
+  EXPECT_EQ(statistics.consume.bytes, 12);
+}
+
+TEST_F(StatisticsFixture, CountsFullAndEmpty) {
+  EXPECT_EQ(ringBuffer.peek(1, true).len, 0);
+  EXPECT_EQ(ringBuffer.peekSegments(1, true).len(), 0);
+
+  ASSERT_EQ(ringBuffer.allocate(kBufferSize, false).len, kBufferSize);
+  EXPECT_EQ(ringBuffer.allocate(1, true).len, 0);
+  EXPECT_EQ(ringBuffer.allocateSegments(1, false).len(), 0);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.peek.rejected, 2);
+  EXPECT_EQ(statistics.allocate.rejected, 2);
+  EXPECT_EQ(statistics.allocate.count, 1);
+}
+
+TEST_F(StatisticsFixture, CountsOutOfOrderRejections) {
+  const Mem first = ringBuffer.allocate(4, false);
+  const Mem second = ringBuffer.allocate(4, false);
+  EXPECT_EQ(ringBuffer.publish(second), 0);
+  EXPECT_EQ(ringBuffer.publish(first), 4);
+  EXPECT_EQ(ringBuffer.consume(Mem{buffer + 2, 2}), 0);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.publish.rejected, 1);
+  EXPECT_EQ(statistics.publish.count, 1);
+  EXPECT_EQ(statistics.consume.rejected, 1);
+}
+
+TEST_F(StatisticsFixture, HighWaterMark) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(6, false)), 6);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  EXPECT_EQ(ringBuffer.statistics().highWaterMark, 10);
+
+  // Allocations into a fuller buffer raise the mark, those into an emptier buffer do not lower it.
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(10, false)), 10);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(2, false)), 2);
+  EXPECT_EQ(ringBuffer.statistics().highWaterMark, 10);
+  ASSERT_EQ(ringBuffer.allocate(4, false).len, 4);
+  ASSERT_EQ(ringBuffer.allocateSegments(10, false).len(), 10);
+  EXPECT_EQ(ringBuffer.statistics().highWaterMark, kBufferSize);
+}
+
+TEST_F(StatisticsFixture, Reset) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  ringBuffer.resetStatistics();
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.count, 0);
+  EXPECT_EQ(statistics.publish.bytes, 0);
+  EXPECT_EQ(statistics.highWaterMark, 0);
+}
+
+TEST_F(StatisticsFixture, NoFillHistogram) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  for (const uint64_t bucket : ringBuffer.statistics().fillHistogram) {
+    EXPECT_EQ(bucket, 0);
+  }
+}
+
+TEST(Statistics, FillHistogram) {
+  using Buffer_t = BasicAtomicRingBuffer<OccupancyTraits>;
+  uint8_t buffer[32];
+  Buffer_t ringBuffer;
+  ringBuffer.init(buffer, sizeof(buffer));
+
+  // Fill levels 1, 3, 5, ..., 31 after each allocation, i.e. one allocation per bucket of 2 bytes.
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(1, false)), 1);
+  for (int i = 1; i < 16; ++i) {
+    ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(2, false)), 2);
+  }
+  // Full buffer.
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(1, false)), 1);
+
+  BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.highWaterMark, 32);
+  for (std::size_t i = 0; i < kFillHistogramBuckets - 1; ++i) {
+    EXPECT_EQ(statistics.fillHistogram[i], 1) << "Bucket " << i;
+  }
+  EXPECT_EQ(statistics.fillHistogram[kFillHistogramBuckets - 1], 2);
+
+  // Only occupancy is recorded.
+  EXPECT_EQ(statistics.allocate.count, 0);
+  EXPECT_EQ(statistics.publish.bytes, 0);
+
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(32, false)), 32);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(1, false)), 1);
+  statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.fillHistogram[0], 2);
+  EXPECT_EQ(statistics.highWaterMark, 32);
+
+  ringBuffer.resetStatistics();
+  statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.highWaterMark, 0);
+  EXPECT_EQ(statistics.fillHistogram[0], 0);
+}
+
+TEST(Statistics, FillLevelWithCachedIndex) {
+  using Buffer_t = BasicAtomicRingBuffer<CachedOccupancyTraits>;
+  uint8_t buffer[16];
+  Buffer_t ringBuffer;
+  ringBuffer.init(buffer, sizeof(buffer));
+
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(12, false)), 12);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(12, false)), 12);
+
+  // Both allocations fit without refreshing the cached read index, which still claims 12 bytes to be in use.
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(2, false)), 2);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocateSegments(2, false)), 2);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.highWaterMark, 12);
+  EXPECT_EQ(statistics.fillHistogram[2], 1);
+  EXPECT_EQ(statistics.fillHistogram[4], 1);
+  EXPECT_EQ(statistics.fillHistogram[12], 1);
+  EXPECT_EQ(statistics.fillHistogram[14], 0);
+  EXPECT_EQ(statistics.fillHistogram[kFillHistogramBuckets - 1], 0);
+}
+
+TEST(Statistics, RejectedObjectPushIsNotAPublish) {
+  ObjectRingBuffer<uint32_t, 2, alignof(uint32_t), CountingTraits> ringBuffer;
+  const uint32_t values[] = {1, 2, 3};
+  ASSERT_EQ(ringBuffer.push(values, 3), 2);
+  EXPECT_EQ(ringBuffer.push(values, 3), 0);
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.rejected, 1);
+  EXPECT_EQ(statistics.publish.count, 1);
+  EXPECT_EQ(statistics.publish.rejected, 0);
+}
+
+TEST(Statistics, DisabledByDefault) {
+  uint8_t buffer[8];
+  AtomicRingBuffer ringBuffer;
+  ringBuffer.init(buffer, sizeof(buffer));
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  EXPECT_EQ(ringBuffer.statistics().allocate.count, 0);
+  EXPECT_EQ(ringBuffer.statistics().highWaterMark, 0);
+}
+
+TEST(Statistics, MultipleProducers) {
+  using Buffer_t = BasicAtomicRingBuffer<CountingMultiProducerTraits>;
+  constexpr std::size_t kBufferSize = 64;
+  constexpr int kNumProducers = 3;
+  constexpr uint64_t kNumPerProducer = 2000;
+
+  uint8_t buffer[kBufferSize];
+  std::vector<Buffer_t::completion_word_type> completionMap(Buffer_t::completionMapSize(kBufferSize));
+  Buffer_t ringBuffer;
+  ringBuffer.init(buffer, kBufferSize, completionMap.data());
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kNumProducers; ++p) {
+    producers.emplace_back([&ringBuffer]() {
+      for (uint64_t i = 0; i < kNumPerProducer;) {
+        const Buffer_t::MemoryRange mem = ringBuffer.allocate(2, false);
+        if (mem.len == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        ringBuffer.publish(mem);
+        ++i;
+      }
+    });
+  }
+
+  uint64_t numConsumed = 0;
+  while (numConsumed < kNumProducers * kNumPerProducer * 2) {
+    const Buffer_t::MemoryRange mem = ringBuffer.peek(kBufferSize, true);
+    if (mem.len == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    numConsumed += ringBuffer.consume(mem);
+  }
+  for (std::thread &producer : producers) {
+    producer.join();
+  }
+
+  const BufferStatistics statistics = ringBuffer.statistics();
+  EXPECT_EQ(statistics.allocate.count, kNumProducers * kNumPerProducer);
+  EXPECT_EQ(statistics.allocate.bytes, kNumProducers * kNumPerProducer * 2);
+  EXPECT_EQ(statistics.publish.count, kNumProducers * kNumPerProducer);
+  EXPECT_EQ(statistics.consume.bytes, numConsumed);
+  EXPECT_LE(statistics.highWaterMark, kBufferSize);
+}
+
+}  // namespace AtomicRingBuffer
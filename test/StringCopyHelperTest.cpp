@@ -1,6 +1,12 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
 #include "AtomicRingBuffer/StringCopyHelper.h"
 
 class StringCopyHelperFixture : public ::testing::Test {
@@ -504,3 +510,421 @@ TEST_F(StringCopyHelperFixture, oversizedSource_PushNewlineToBorder) {
   EXPECT_EQ(result.nextByte, dstBuf_ + kBufferSize_);
   EXPECT_EQ(result.partialReplace, replace + 1);
 }
+
+TEST(StringCopyHelper, implementationsMatchScalar) {
+  std::size_t numImplementations = 0;
+  const AtomicRingBuffer::detail::memcpyCharReplaceImplementation* implementations =
+      AtomicRingBuffer::detail::memcpyCharReplaceImplementations(numImplementations);
+  ASSERT_GE(numImplementations, 1);
+  const auto scalar = implementations[numImplementations - 1];
+  ASSERT_STREQ(scalar.name, "scalar");
+
+  constexpr std::size_t kMaxLen = 200;
+  const char* const replacements[] = {nullptr, "", "\r\n", "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGH"};
+  std::mt19937 random(42);
+
+  for (std::size_t impl = 0; impl + 1 < numImplementations; ++impl) {
+    for (const unsigned matchDistance : {1u, 2u, 5u, 40u, 1000u}) {
+      for (int round = 0; round < 200; ++round) {
+        std::vector<char> src(random() % kMaxLen);
+        for (char& c : src) {
+          c = (random() % matchDistance == 0) ? '\n' : static_cast<char>('a' + random() % 26);
+        }
+        const std::size_t destLen = random() % (3 * kMaxLen);
+        const char* const replace = replacements[random() % 4];
+
+        std::vector<char> expected(destLen + 1, '\xFF');
+        std::vector<char> actual(destLen + 1, '\xFF');
+        const auto expectedResult = scalar.function(expected.data(), src.data(), '\n', replace, destLen, src.size());
+        const auto actualResult =
+            implementations[impl].function(actual.data(), src.data(), '\n', replace, destLen, src.size());
+
+        SCOPED_TRACE(std::string(implementations[impl].name) + ", srcLen " + std::to_string(src.size()) +
+                     ", destLen " + std::to_string(destLen));
+        ASSERT_EQ(actualResult.len, expectedResult.len);
+        ASSERT_EQ(actualResult.nextByte == nullptr, expectedResult.nextByte == nullptr);
+        if (expectedResult.nextByte != nullptr) {
+          ASSERT_EQ(actualResult.nextByte - actual.data(), expectedResult.nextByte - expected.data());
+        }
+        ASSERT_EQ(actualResult.partialReplace, expectedResult.partialReplace);
+        ASSERT_EQ(actual, expected);
+      }
+    }
+  }
+}
+
+namespace {
+
+/**
+ * \brief Escape table for JSON strings. Holds the replacement strings of the control characters.
+ */
+struct JsonEscapeTable {
+  JsonEscapeTable() : controlEscapes(0x20) {
+    for (std::size_t i = 0; i < controlEscapes.size(); ++i) {
+      char escape[7];
+      snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(i));
+      controlEscapes[i] = escape;
+      table.set(static_cast<char>(i), controlEscapes[i].c_str());
+    }
+    table.set('\n', "\\n");
+    table.set('"', "\\\"");
+    table.set('\\', "\\\\");
+  }
+
+  std::vector<std::string> controlEscapes;
+  AtomicRingBuffer::CharReplaceTable table;
+};
+
+}  // namespace
+
+TEST(StringCopyHelper, tableEmpty) {
+  AtomicRingBuffer::CharReplaceTable table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.replacement('a'), nullptr);
+
+  const char text[] = "plain text";
+  char dest[sizeof(text)];
+  auto result = AtomicRingBuffer::memcpyCharReplace(dest, text, table, sizeof(dest), sizeof(text));
+  EXPECT_EQ(result.len, sizeof(text));
+  EXPECT_EQ(result.nextByte, dest + sizeof(text));
+  EXPECT_EQ(result.partialReplace, nullptr);
+  EXPECT_STREQ(dest, text);
+}
+
+TEST(StringCopyHelper, tableJsonEscape) {
+  JsonEscapeTable json;
+  EXPECT_TRUE(json.table.vectorizable());
+  EXPECT_EQ(json.table.vectorRangeEnd(), 0x20);
+  EXPECT_STREQ(json.table.replacement('\x01'), "\\u0001");
+  EXPECT_EQ(json.table.replacementLen('\x01'), 6);
+
+  const std::string text = "{\"key\": \"a\\b\nc\x01\"} and some more text to fill a couple of vector blocks.";
+  const std::string expected =
+      "{\\\"key\\\": \\\"a\\\\b\\nc\\u0001\\\"} and some more text to fill a couple of vector blocks.";
+  std::vector<char> dest(2 * text.size());
+  auto result = AtomicRingBuffer::memcpyCharReplace(dest.data(), text.data(), json.table, dest.size(), text.size());
+  EXPECT_EQ(result.len, text.size());
+  EXPECT_EQ(result.partialReplace, nullptr);
+  ASSERT_EQ(result.nextByte, dest.data() + expected.size());
+  EXPECT_EQ(std::string(dest.data(), expected.size()), expected);
+}
+
+TEST(StringCopyHelper, tableRemoveAndReset) {
+  AtomicRingBuffer::CharReplaceTable table;
+  table.set('\r', "");
+  table.set('\n', "\\n");
+  EXPECT_TRUE(table.removesBytes());
+  table.set('\n', nullptr);
+  EXPECT_FALSE(table.empty());
+
+  const std::string text = "line 1\r\nline 2\r\n";
+  char dest[32];
+  auto result = AtomicRingBuffer::memcpyCharReplace(dest, text.data(), table, sizeof(dest), text.size());
+  EXPECT_EQ(result.len, text.size());
+  EXPECT_EQ(std::string(dest, result.nextByte), "line 1\nline 2\n");
+}
+
+TEST(StringCopyHelper, tablePartialReplace) {
+  JsonEscapeTable json;
+  const std::string text = "ab\x02yz";
+  char dest[5];
+  auto result = AtomicRingBuffer::memcpyCharReplace(dest, text.data(), json.table, sizeof(dest), text.size());
+  EXPECT_EQ(result.len, 3);
+  EXPECT_EQ(result.nextByte, dest + sizeof(dest));
+  EXPECT_EQ(std::string(dest, sizeof(dest)), "ab\\u0");
+  EXPECT_EQ(result.partialReplace, json.table.replacement('\x02') + 3);
+  EXPECT_STREQ(result.partialReplace, "002");
+}
+
+TEST(StringCopyHelper, tableManySearchBytesNotVectorizable) {
+  AtomicRingBuffer::CharReplaceTable table;
+  for (const char c : std::string("abcd")) {
+    table.set(c, "_");
+  }
+  EXPECT_TRUE(table.vectorizable());
+  table.set('e', "_");
+  EXPECT_FALSE(table.vectorizable());
+
+  const std::string text = "abcdefghij";
+  char dest[16];
+  auto result = AtomicRingBuffer::memcpyCharReplace(dest, text.data(), table, sizeof(dest), text.size());
+  EXPECT_EQ(std::string(dest, result.nextByte), "_____fghij");
+}
+
+TEST(StringCopyHelper, tableImplementationsMatchScalar) {
+  std::size_t numImplementations = 0;
+  const AtomicRingBuffer::detail::memcpyCharReplaceImplementation* implementations =
+      AtomicRingBuffer::detail::memcpyCharReplaceImplementations(numImplementations);
+  const auto scalar = implementations[numImplementations - 1];
+
+  JsonEscapeTable json;
+  AtomicRingBuffer::CharReplaceTable slip;
+  slip.set('\xC0', "\xDB\xDC");
+  slip.set('\xDB', "\xDB\xDD");
+  AtomicRingBuffer::CharReplaceTable csv;
+  csv.set('"', "\"\"");
+  csv.set(',', "\\,");
+  csv.set('\r', "");
+  csv.set('\n', "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGH");
+  AtomicRingBuffer::CharReplaceTable scalarOnly;
+  for (const char c : std::string("abcdef")) {
+    scalarOnly.set(c, "<>");
+  }
+  const AtomicRingBuffer::CharReplaceTable* const tables[] = {&json.table, &slip, &csv, &scalarOnly};
+
+  constexpr std::size_t kMaxLen = 200;
+  std::mt19937 random(42);
+
+  for (std::size_t impl = 0; impl + 1 < numImplementations; ++impl) {
+    for (const AtomicRingBuffer::CharReplaceTable* table : tables) {
+      for (const unsigned matchDistance : {1u, 3u, 40u, 1000u}) {
+        for (int round = 0; round < 100; ++round) {
+          std::vector<char> src(random() % kMaxLen);
+          for (char& c : src) {
+            c = (random() % matchDistance == 0) ? static_cast<char>(random()) : static_cast<char>('g' + random() % 20);
+          }
+          const std::size_t destLen = random() % (3 * kMaxLen);
+
+          std::vector<char> expected(destLen + 1, '\xFF');
+          std::vector<char> actual(destLen + 1, '\xFF');
+          const auto expectedResult = scalar.tableFunction(expected.data(), src.data(), *table, destLen, src.size());
+          const auto actualResult =
+              implementations[impl].tableFunction(actual.data(), src.data(), *table, destLen, src.size());
+
+          SCOPED_TRACE(std::string(implementations[impl].name) + ", srcLen " + std::to_string(src.size()) +
+                       ", destLen " + std::to_string(destLen));
+          ASSERT_EQ(actualResult.len, expectedResult.len);
+          ASSERT_EQ(actualResult.nextByte == nullptr, expectedResult.nextByte == nullptr);
+          if (expectedResult.nextByte != nullptr) {
+            ASSERT_EQ(actualResult.nextByte - actual.data(), expectedResult.nextByte - expected.data());
+          }
+          ASSERT_EQ(actualResult.partialReplace, expectedResult.partialReplace);
+          ASSERT_EQ(actual, expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(StringCopyHelper, encoderResumesReplacement) {
+  AtomicRingBuffer::CharReplaceEncoder encoder('\n', "<NL>");
+  const std::string text = "a\nb\n";
+
+  // Encode into chunks of 3 bytes, which splits both replacements.
+  std::string output;
+  std::size_t consumed = 0;
+  while (consumed < text.size() || encoder.pending()) {
+    char chunk[3];
+    auto result = encoder.encode(chunk, text.data() + consumed, sizeof(chunk), text.size() - consumed);
+    consumed += result.len;
+    EXPECT_EQ(result.partialReplace, encoder.pendingReplace());
+    output.append(chunk, result.nextByte);
+  }
+  EXPECT_EQ(output, "a<NL>b<NL>");
+}
+
+TEST(StringCopyHelper, encoderEncodedLen) {
+  AtomicRingBuffer::CharReplaceEncoder encoder('\n', "<NL>");
+  const std::string text = "a\nb\n";
+  EXPECT_EQ(encoder.encodedLen(text.data(), text.size(), 100), 10);
+  EXPECT_EQ(encoder.encodedLen(text.data(), text.size(), 4), 4);
+
+  char chunk[3];
+  encoder.encode(chunk, text.data(), sizeof(chunk), text.size());
+  ASSERT_STREQ(encoder.pendingReplace(), "L>");
+  EXPECT_EQ(encoder.encodedLen(nullptr, 0, 100), 2);
+  EXPECT_EQ(encoder.encodedLen(text.data() + 2, 2, 100), 7);
+}
+
+TEST(StringCopyHelper, encoderIntoRingBuffer) {
+  constexpr std::size_t kBufferSize = 16;
+  uint8_t storage[kBufferSize];
+  AtomicRingBuffer::AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, kBufferSize);
+
+  JsonEscapeTable json;
+  AtomicRingBuffer::CharReplaceEncoder encoder(json.table);
+
+  std::string text;
+  std::string expected;
+  for (int i = 0; i < 20; ++i) {
+    text += "line \"" + std::to_string(i) + "\"\n";
+    expected += "line \\\"" + std::to_string(i) + "\\\"\\n";
+  }
+
+  // The consumer drains the buffer after every call, so the encoder writes across the wrap-around point many times.
+  std::string output;
+  std::size_t consumed = 0;
+  while (consumed < text.size() || encoder.pending()) {
+    const std::size_t len = encoder.encodeInto(ringBuffer, text.data() + consumed, text.size() - consumed);
+    consumed += len;
+    auto data = ringBuffer.peek(kBufferSize, true);
+    ASSERT_NE(data.len, 0);
+    output.append(reinterpret_cast<const char*>(data.ptr), data.len);
+    ASSERT_EQ(ringBuffer.consume(data), data.len);
+  }
+  auto data = ringBuffer.peek(kBufferSize, true);
+  output.append(reinterpret_cast<const char*>(data.ptr), data.len);
+  ringBuffer.consume(data);
+
+  EXPECT_EQ(output, expected);
+  EXPECT_TRUE(ringBuffer.empty());
+}
+
+TEST(StringCopyHelper, encoderIntoRingBufferRemovesBytes) {
+  uint8_t storage[8];
+  AtomicRingBuffer::AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, sizeof(storage));
+  AtomicRingBuffer::CharReplaceEncoder encoder('\r', "");
+
+  EXPECT_EQ(encoder.encodeInto(ringBuffer, "ab\r", 3), 3);
+  EXPECT_EQ(encoder.encodeInto(ringBuffer, "\r\r", 2), 2);
+  EXPECT_EQ(ringBuffer.size(), 2);
+  auto data = ringBuffer.peek(8, true);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data.ptr), data.len), "ab");
+}
+
+TEST(StringCopyHelper, encoderIntoRingBufferRejectedPublish) {
+  uint8_t storage[8];
+  AtomicRingBuffer::AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, sizeof(storage));
+  AtomicRingBuffer::CharReplaceEncoder encoder('"', "\\\"");
+
+  // The chunk cannot be published before the earlier allocation, so nothing is consumed and the chunk is returned.
+  auto earlier = ringBuffer.allocate(2, false);
+  ASSERT_EQ(earlier.len, 2);
+  EXPECT_EQ(encoder.encodeInto(ringBuffer, "a\"", 2), 0);
+  EXPECT_FALSE(encoder.pending());
+  ASSERT_EQ(ringBuffer.publish(earlier), 2);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(2, false)), 2);
+
+  EXPECT_EQ(encoder.encodeInto(ringBuffer, "a\"", 2), 2);
+  auto data = ringBuffer.peek(8, true);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(data.ptr), data.len), "a\\\"");
+}
+
+TEST(StringCopyHelper, decoderSingleCharacter) {
+  AtomicRingBuffer::CharReplaceDecoder decoder('\n', "\r\n");
+  EXPECT_TRUE(decoder.valid());
+
+  // A lone \r is not a replacement and is copied unchanged.
+  const std::string text = "a\r\nb\rc\r\r\n";
+  char dest[16];
+  auto result = decoder.decode(dest, text.data(), sizeof(dest), text.size());
+  EXPECT_EQ(result.len, text.size());
+  EXPECT_EQ(std::string(dest, result.nextByte), "a\nb\rc\r\n");
+  EXPECT_FALSE(decoder.pending());
+}
+
+TEST(StringCopyHelper, decoderResumesAcrossChunks) {
+  JsonEscapeTable json;
+  AtomicRingBuffer::CharReplaceDecoder decoder(json.table);
+  EXPECT_TRUE(decoder.valid());
+
+  const std::string encoded = "x\\u0001y\\\\\\\"z\\n";
+  const std::string expected = "x\x01y\\\"z\n";
+
+  // Split the input at every possible position.
+  for (std::size_t split = 0; split <= encoded.size(); ++split) {
+    char dest[32];
+    auto result = decoder.decode(dest, encoded.data(), sizeof(dest), split);
+    EXPECT_EQ(result.len, split);
+    result = decoder.decode(result.nextByte, encoded.data() + split, dest + sizeof(dest) - result.nextByte,
+                            encoded.size() - split);
+    EXPECT_EQ(result.len, encoded.size() - split);
+    EXPECT_FALSE(decoder.pending());
+    EXPECT_EQ(std::string(dest, result.nextByte), expected) << "split: " << split;
+  }
+}
+
+TEST(StringCopyHelper, decoderFinishIncomplete) {
+  JsonEscapeTable json;
+  AtomicRingBuffer::CharReplaceDecoder decoder(json.table);
+
+  const std::string encoded = "ab\\u00";
+  char dest[16];
+  auto result = decoder.decode(dest, encoded.data(), sizeof(dest), encoded.size());
+  EXPECT_EQ(result.len, encoded.size());
+  EXPECT_EQ(result.nextByte, dest + 2);
+  EXPECT_TRUE(decoder.pending());
+
+  // The incomplete sequence is copied unchanged at the end of the input.
+  char* end = decoder.finish(result.nextByte, dest + sizeof(dest) - result.nextByte);
+  EXPECT_EQ(std::string(dest, end), encoded);
+  EXPECT_FALSE(decoder.pending());
+}
+
+TEST(StringCopyHelper, decoderDestFull) {
+  AtomicRingBuffer::CharReplaceDecoder decoder('\n', "\\n");
+  const std::string encoded = "ab\\ncd";
+  char dest[3];
+  auto result = decoder.decode(dest, encoded.data(), sizeof(dest), encoded.size());
+  EXPECT_EQ(result.len, 4);
+  EXPECT_EQ(std::string(dest, result.nextByte), "ab\n");
+}
+
+TEST(StringCopyHelper, decoderInvalidTable) {
+  AtomicRingBuffer::CharReplaceTable table;
+  table.set('a', "\\a");
+  table.set('b', "\\ab");
+  EXPECT_FALSE(AtomicRingBuffer::CharReplaceDecoder(table).valid());
+
+  table.set('b', "/b");
+  EXPECT_FALSE(AtomicRingBuffer::CharReplaceDecoder(table).valid());
+
+  table.set('b', "\\b");
+  EXPECT_TRUE(AtomicRingBuffer::CharReplaceDecoder(table).valid());
+}
+
+TEST(StringCopyHelper, decoderRoundTripThroughRingBuffer) {
+  constexpr std::size_t kBufferSize = 16;
+  uint8_t storage[kBufferSize];
+  AtomicRingBuffer::AtomicRingBuffer ringBuffer;
+  ringBuffer.init(storage, kBufferSize);
+
+  JsonEscapeTable json;
+  AtomicRingBuffer::CharReplaceEncoder encoder(json.table);
+  AtomicRingBuffer::CharReplaceDecoder decoder(json.table);
+
+  std::string text;
+  std::mt19937 random(7);
+  for (int i = 0; i < 500; ++i) {
+    text += (random() % 4 == 0) ? static_cast<char>(random() % 0x24) : static_cast<char>('a' + random() % 26);
+  }
+
+  // Escape sequences regularly end up split across the end of the buffer.
+  std::string output;
+  std::size_t consumed = 0;
+  while (consumed < text.size() || encoder.pending() || !ringBuffer.empty()) {
+    consumed += encoder.encodeInto(ringBuffer, text.data() + consumed, text.size() - consumed);
+    char dest[7];
+    const std::size_t len = decoder.decodeFrom(ringBuffer, dest, sizeof(dest));
+    output.append(dest, len);
+  }
+  EXPECT_FALSE(decoder.pending());
+  EXPECT_EQ(output, text);
+}
+
+TEST(StringCopyHelper, untilImplementationsMatchScalar) {
+  std::size_t numImplementations = 0;
+  const AtomicRingBuffer::detail::memcpyCharReplaceImplementation* implementations =
+      AtomicRingBuffer::detail::memcpyCharReplaceImplementations(numImplementations);
+  const auto scalar = implementations[numImplementations - 1];
+  std::mt19937 random(42);
+
+  for (std::size_t impl = 0; impl + 1 < numImplementations; ++impl) {
+    for (int round = 0; round < 500; ++round) {
+      std::vector<char> src(random() % 300);
+      const unsigned matchDistance = 1 + random() % 200;
+      for (char& c : src) {
+        c = (random() % matchDistance == 0) ? '\\' : static_cast<char>('a' + random() % 26);
+      }
+      std::vector<char> expected(src.size(), '\xFF');
+      std::vector<char> actual(src.size(), '\xFF');
+      ASSERT_EQ(implementations[impl].untilFunction(actual.data(), src.data(), '\\', src.size()),
+                scalar.untilFunction(expected.data(), src.data(), '\\', src.size()))
+          << implementations[impl].name;
+      ASSERT_EQ(actual, expected) << implementations[impl].name;
+    }
+  }
+}
@@ -0,0 +1,142 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "AtomicRingBuffer/AtomicRingBuffer.h"
+#include "AtomicRingBuffer/ObjectRingBuffer.h"
+
+namespace AtomicRingBuffer {
+
+struct TracedTraits : public DefaultTraits {
+  using Tracing = EventTracing;
+};
+
+class TraceFixture : public ::testing::Test {
+ public:
+  using Buffer_t = BasicAtomicRingBuffer<TracedTraits>;
+
+  void SetUp() {
+    TraceLog::clear();
+    ringBuffer.init(buffer, sizeof(buffer));
+  }
+
+  void TearDown() { TraceLog::clear(); }
+
+  /**
+   * \brief Write the trace log and return what was written.
+   */
+  static std::string writeTrace(std::size_t &numEvents) {
+    std::FILE *file = std::tmpfile();
+    numEvents = TraceLog::writeChromeTrace(file);
+    std::string contents(static_cast<std::size_t>(std::ftell(file)), '\0');
+    std::rewind(file);
+    contents.resize(std::fread(&contents[0], 1, contents.size(), file));
+    std::fclose(file);
+    return contents;
+  }
+
+  static std::size_t countOccurrences(const std::string &text, const std::string &pattern) {
+    std::size_t count = 0;
+    for (std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+      ++count;
+    }
+    return count;
+  }
+
+  uint8_t buffer[16];
+  Buffer_t ringBuffer;
+};
+
+TEST_F(TraceFixture, RecordsSuccessfulOperations) {
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4);
+  ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(6, false)), 6);
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(10, false)), 10);
+
+  // Failed operations are not recorded.
+  EXPECT_EQ(ringBuffer.peek(1, false).len, 0);
+  EXPECT_EQ(ringBuffer.allocate(20, false).len, 0);
+
+  std::size_t numEvents = 0;
+  const std::string trace = writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 6);
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+  EXPECT_EQ(countOccurrences(trace, "\"name\":\"allocate\""), 2);
+  EXPECT_EQ(countOccurrences(trace, "\"name\":\"publish\""), 2);
+  EXPECT_EQ(countOccurrences(trace, "\"name\":\"peek\""), 1);
+  EXPECT_EQ(countOccurrences(trace, "\"name\":\"consume\""), 1);
+  EXPECT_NE(trace.find("\"index\":4,\"len\":6"), std::string::npos);
+  EXPECT_NE(trace.find("\"index\":0,\"len\":10"), std::string::npos);
+
+  // Writing consumes the events.
+  writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 0);
+}
+
+TEST_F(TraceFixture, SeparateThreads) {
+  std::thread producer([this]() { ASSERT_EQ(ringBuffer.publish(ringBuffer.allocate(4, false)), 4); });
+  producer.join();
+  ASSERT_EQ(ringBuffer.consume(ringBuffer.peek(4, false)), 4);
+
+  std::size_t numEvents = 0;
+  const std::string trace = writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 4);
+
+  // Producer and consumer events are on different timelines.
+  const std::size_t publishTid = trace.find("\"tid\":", trace.find("\"name\":\"publish\""));
+  const std::size_t consumeTid = trace.find("\"tid\":", trace.find("\"name\":\"consume\""));
+  ASSERT_NE(publishTid, std::string::npos);
+  ASSERT_NE(consumeTid, std::string::npos);
+  EXPECT_NE(trace.substr(publishTid, trace.find(',', publishTid) - publishTid),
+            trace.substr(consumeTid, trace.find(',', consumeTid) - consumeTid));
+}
+
+TEST_F(TraceFixture, DropsWhenFull) {
+  std::thread producer([this]() {
+    TraceLog::setEventsPerThread(2);
+    ringBuffer.publish(ringBuffer.allocate(4, false));
+    ringBuffer.publish(ringBuffer.allocate(4, false));
+    TraceLog::setEventsPerThread(TraceLog::kDefaultEventsPerThread);
+  });
+  producer.join();
+  EXPECT_EQ(TraceLog::numDropped(), 2);
+
+  std::size_t numEvents = 0;
+  writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 2);
+}
+
+TEST_F(TraceFixture, ObjectRingBuffer) {
+  ObjectRingBuffer<uint32_t, 4, alignof(uint32_t), TracedTraits> objectBuffer;
+  EXPECT_TRUE(objectBuffer.push(1));
+  EXPECT_TRUE(objectBuffer.push(2));
+  EXPECT_TRUE(objectBuffer.pop());
+
+  std::size_t numEvents = 0;
+  const std::string trace = writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 6);
+  // The second element starts at byte 4.
+  EXPECT_NE(trace.find("\"name\":\"allocate\",\"cat\":\"AtomicRingBuffer\""), std::string::npos);
+  EXPECT_NE(trace.find("\"index\":4,\"len\":4"), std::string::npos);
+}
+
+TEST_F(TraceFixture, ExitedThreadsAreFreedAfterWriting) {
+  for (int i = 0; i < 3; ++i) {
+    ringBuffer.publish(ringBuffer.allocate(1, false));
+  }
+  const std::size_t numBuffers = TraceLog::numThreadBuffers();
+  for (int t = 0; t < 3; ++t) {
+    std::thread([this]() { ringBuffer.consume(ringBuffer.peek(1, false)); }).join();
+  }
+  EXPECT_EQ(TraceLog::numThreadBuffers(), numBuffers + 3);
+
+  // The events of exited threads are written before their buffers are freed.
+  std::size_t numEvents = 0;
+  writeTrace(numEvents);
+  EXPECT_EQ(numEvents, 6 + 3 * 2);
+  EXPECT_EQ(TraceLog::numThreadBuffers(), numBuffers);
+}
+
+}  // namespace AtomicRingBuffer
@@ -9,86 +9,95 @@ namespace AtomicRingBuffer {
 
 // Test wrap-around publish with/without accept partial
 
-TEST_F(FilledAtomicBufferFixture, MatchingAllocate_Full) {
-  Mem mem = ringBuffer.allocate(3, false);
+TYPED_TEST(FilledAtomicBufferFixture, MatchingAllocate_Full) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(3, false);
   EXPECT_EQ(mem.len, 3);
-  EXPECT_EQ(mem.ptr, buffer + kInitialFill);
+  EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
 }
 
-TEST_F(FilledAtomicBufferFixture, MatchingAllocate_Partial) {
-  Mem mem = ringBuffer.allocate(3, true);
+TYPED_TEST(FilledAtomicBufferFixture, MatchingAllocate_Partial) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(3, true);
   EXPECT_EQ(mem.len, 3);
-  EXPECT_EQ(mem.ptr, buffer + kInitialFill);
+  EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
 }
 
-TEST_F(FilledAtomicBufferFixture, PartialAllocate_Full) {
-  Mem mem = ringBuffer.allocate(5, false);
+TYPED_TEST(FilledAtomicBufferFixture, PartialAllocate_Full) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(5, false);
   EXPECT_EQ(mem, Mem());
 }
 
-TEST_F(FilledAtomicBufferFixture, PartialAllocate_Partial) {
-  Mem mem = ringBuffer.allocate(5, true);
+TYPED_TEST(FilledAtomicBufferFixture, PartialAllocate_Partial) {
+  using Mem = typename TestFixture::Mem;
+  Mem mem = this->ringBuffer.allocate(5, true);
   EXPECT_EQ(mem.len, 3);
-  EXPECT_EQ(mem.ptr, buffer + kInitialFill);
+  EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
 }
 
-TEST_F(FilledAtomicBufferFixture, Consume_MatchingAllocate_Full) {
-  consume5BytesAtStart();
+TYPED_TEST(FilledAtomicBufferFixture, Consume_MatchingAllocate_Full) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
   {
-    Mem mem = ringBuffer.allocate(3, true);
+    Mem mem = this->ringBuffer.allocate(3, true);
     EXPECT_EQ(mem.len, 3);
-    EXPECT_EQ(mem.ptr, buffer + kInitialFill);
+    EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
   }
 }
 
-TEST_F(FilledAtomicBufferFixture, Consume_MatchingAllocate_Partial) {
-  consume5BytesAtStart();
+TYPED_TEST(FilledAtomicBufferFixture, Consume_MatchingAllocate_Partial) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
   {
-    Mem mem = ringBuffer.allocate(3, false);
+    Mem mem = this->ringBuffer.allocate(3, false);
     EXPECT_EQ(mem.len, 3);
-    EXPECT_EQ(mem.ptr, buffer + kInitialFill);
+    EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
   }
 }
 
-TEST_F(FilledAtomicBufferFixture, Consume_PartialAllocate_Full) {
-  consume5BytesAtStart();
+TYPED_TEST(FilledAtomicBufferFixture, Consume_PartialAllocate_Full) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
   {
-    Mem mem = ringBuffer.allocate(5, true);
+    Mem mem = this->ringBuffer.allocate(5, true);
     EXPECT_EQ(mem.len, 3);
-    EXPECT_EQ(mem.ptr, buffer + kInitialFill);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
   {
-    Mem mem = ringBuffer.allocate(5, true);
+    Mem mem = this->ringBuffer.allocate(5, true);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
 }
 
-TEST_F(FilledAtomicBufferFixture, Consume_PartialAllocate_Partial) {
-  consume5BytesAtStart();
+TYPED_TEST(FilledAtomicBufferFixture, Consume_PartialAllocate_Partial) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 0);
     EXPECT_EQ(mem.ptr, nullptr);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
   {
-    Mem mem = ringBuffer.allocate(3, false);
+    Mem mem = this->ringBuffer.allocate(3, false);
     EXPECT_EQ(mem.len, 3);
-    EXPECT_EQ(mem.ptr, buffer + kInitialFill);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(mem.ptr, this->buffer + TestFixture::kInitialFill);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
   {
-    Mem mem = ringBuffer.allocate(5, false);
+    Mem mem = this->ringBuffer.allocate(5, false);
     EXPECT_EQ(mem.len, 5);
-    EXPECT_EQ(mem.ptr, buffer);
-    EXPECT_EQ(ringBuffer.size(), 2);
+    EXPECT_EQ(mem.ptr, this->buffer);
+    EXPECT_EQ(this->ringBuffer.size(), 2);
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, FullCircle_ManyBytes) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCircle_ManyBytes) {
+  using Mem = typename TestFixture::Mem;
   // Send 200 integers of increasing range in chunks of 3
   uint8_t sendData = 0;
   uint8_t readData = 0;
@@ -96,163 +105,170 @@ TEST_F(BufferedAtomicBufferFixture, FullCircle_ManyBytes) {
   while (sendData < 200) {
     // Send two packets and advance sendData by how many bytes were sent.
     for (int i = 0; i < 2; ++i) {
-      Mem mem = ringBuffer.allocate(3, true);
+      Mem mem = this->ringBuffer.allocate(3, true);
       ASSERT_GT(mem.len, 0);
       ASSERT_LE(mem.len, 3);
       ASSERT_NE(mem.ptr, nullptr);
-      EXPECT_EQ(ringBuffer.size(), sendData - readData);
+      EXPECT_EQ(this->ringBuffer.size(), sendData - readData);
 
-      for (AtomicRingBuffer::size_type j = 0; j < mem.len; ++j) {
-        mem.ptr[j] = static_cast<AtomicRingBuffer::value_type>(sendData + j);
+      for (typename TypeParam::size_type j = 0; j < mem.len; ++j) {
+        mem.ptr[j] = static_cast<typename TypeParam::value_type>(sendData + j);
       }
-      sendData += static_cast<AtomicRingBuffer::value_type>(mem.len);
+      sendData += static_cast<typename TypeParam::value_type>(mem.len);
 
-      ASSERT_EQ(ringBuffer.publish(mem), mem.len) << "Error publishing at byte " << static_cast<uint16_t>(sendData);
-      EXPECT_EQ(ringBuffer.size(), sendData - readData);
+      ASSERT_EQ(this->ringBuffer.publish(mem), mem.len)
+          << "Error publishing at byte " << static_cast<uint16_t>(sendData);
+      EXPECT_EQ(this->ringBuffer.size(), sendData - readData);
     }
 
     // Read integers in chunks of up to 5
     {
-      EXPECT_EQ(ringBuffer.size(), sendData - readData);
-      Mem mem = ringBuffer.peek(5, true);
+      EXPECT_EQ(this->ringBuffer.size(), sendData - readData);
+      Mem mem = this->ringBuffer.peek(5, true);
       ASSERT_GT(mem.len, 0);
       ASSERT_LE(mem.len, 5);
       ASSERT_NE(mem.ptr, nullptr);
 
-      for (AtomicRingBuffer::size_type j = 0; j < mem.len; ++j) {
+      for (typename TypeParam::size_type j = 0; j < mem.len; ++j) {
         EXPECT_EQ(mem.ptr[j], j + readData) << "Error reading at byte " << static_cast<uint16_t>(readData);
       }
-      readData += static_cast<AtomicRingBuffer::value_type>(mem.len);
+      readData += static_cast<typename TypeParam::value_type>(mem.len);
 
-      ASSERT_EQ(ringBuffer.consume(mem), mem.len) << "Error consuming at byte " << static_cast<uint16_t>(readData);
-      EXPECT_EQ(ringBuffer.size(), sendData - readData);
+      ASSERT_EQ(this->ringBuffer.consume(mem), mem.len)
+          << "Error consuming at byte " << static_cast<uint16_t>(readData);
+      EXPECT_EQ(this->ringBuffer.size(), sendData - readData);
     }
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, FullCircle_WriteBeforeRead) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCircle_WriteBeforeRead) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(kBufferSize, false);
-    ASSERT_EQ(mem.len, kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    Mem mem = this->ringBuffer.allocate(TestFixture::kBufferSize, false);
+    ASSERT_EQ(mem.len, TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
     // Push so that the buffer is completely full
-    ASSERT_EQ(ringBuffer.publish(mem), kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    ASSERT_EQ(this->ringBuffer.publish(mem), TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
 
     // Consume the entire buffer
-    ASSERT_EQ(ringBuffer.consume(mem), kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    mem = this->ringBuffer.peek(TestFixture::kBufferSize, false);
+    ASSERT_EQ(this->ringBuffer.consume(mem), TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
 
     // Fill the buffer again
-    mem = ringBuffer.allocate(kBufferSize, false);
-    ASSERT_EQ(mem.len, kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), 0);
-    ASSERT_EQ(ringBuffer.publish(mem), kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    mem = this->ringBuffer.allocate(TestFixture::kBufferSize, false);
+    ASSERT_EQ(mem.len, TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
+    ASSERT_EQ(this->ringBuffer.publish(mem), TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
   }
 
   {
     // Consume 3 bytes
-    Mem mem = ringBuffer.peek(3, true);
+    Mem mem = this->ringBuffer.peek(3, true);
     ASSERT_EQ(mem.len, 3);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 7);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 7);
 
     // Consume whatever there is left.
-    mem = ringBuffer.peek(std::numeric_limits<AtomicRingBuffer::size_type>::max(), true);
+    mem = this->ringBuffer.peek(std::numeric_limits<typename TypeParam::size_type>::max(), true);
     ASSERT_EQ(mem.len, 7);
-    EXPECT_EQ(ringBuffer.size(), 7);
+    EXPECT_EQ(this->ringBuffer.size(), 7);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 7);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 7);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, FullCircle_LessOneByte) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCircle_LessOneByte) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(kBufferSize, false);
-    ASSERT_EQ(mem.len, kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    Mem mem = this->ringBuffer.allocate(TestFixture::kBufferSize, false);
+    ASSERT_EQ(mem.len, TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
     // Push so that the buffer is completely full
-    ASSERT_EQ(ringBuffer.publish(mem), kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    ASSERT_EQ(this->ringBuffer.publish(mem), TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
 
     // Consume the entire buffer less one byte
-    mem.len = kBufferSize - 1;
-    ASSERT_EQ(ringBuffer.consume(mem), kBufferSize - 1);
-    EXPECT_EQ(ringBuffer.size(), 1);
+    mem = this->ringBuffer.peek(TestFixture::kBufferSize - 1, false);
+    ASSERT_EQ(this->ringBuffer.consume(mem), TestFixture::kBufferSize - 1);
+    EXPECT_EQ(this->ringBuffer.size(), 1);
 
     // Fill the buffer again
-    mem = ringBuffer.allocate(kBufferSize, true);
-    ASSERT_EQ(mem.len, kBufferSize - 1);
-    EXPECT_EQ(ringBuffer.size(), 1);
-    ASSERT_EQ(ringBuffer.publish(mem), kBufferSize - 1);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    mem = this->ringBuffer.allocate(TestFixture::kBufferSize, true);
+    ASSERT_EQ(mem.len, TestFixture::kBufferSize - 1);
+    EXPECT_EQ(this->ringBuffer.size(), 1);
+    ASSERT_EQ(this->ringBuffer.publish(mem), TestFixture::kBufferSize - 1);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
   }
 
   {
     // Consume 1 byte before wraparound
-    Mem mem = ringBuffer.peek(3, true);
+    Mem mem = this->ringBuffer.peek(3, true);
     ASSERT_EQ(mem.len, 1);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 1);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize - 1);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 1);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize - 1);
 
-    mem = ringBuffer.peek(std::numeric_limits<AtomicRingBuffer::size_type>::max(), true);
+    mem = this->ringBuffer.peek(std::numeric_limits<typename TypeParam::size_type>::max(), true);
     // Consume whatever there is left.
     ASSERT_EQ(mem.len, 9);
-    EXPECT_EQ(ringBuffer.size(), 9);
+    EXPECT_EQ(this->ringBuffer.size(), 9);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 9);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 9);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, FullCircle_ReadAtFirstWraparound) {
+TYPED_TEST(BufferedAtomicBufferFixture, FullCircle_ReadAtFirstWraparound) {
+  using Mem = typename TestFixture::Mem;
   {
-    Mem mem = ringBuffer.allocate(kBufferSize, false);
-    ASSERT_EQ(mem.len, kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    Mem mem = this->ringBuffer.allocate(TestFixture::kBufferSize, false);
+    ASSERT_EQ(mem.len, TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
     // Push so that the buffer is completely full
-    ASSERT_EQ(ringBuffer.publish(mem), kBufferSize);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    ASSERT_EQ(this->ringBuffer.publish(mem), TestFixture::kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
 
     // Consume 3 bytes
-    mem.len = 3;
-    ASSERT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 7);
+    mem = this->ringBuffer.peek(3, false);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 7);
 
     // Fill the buffer again by publishing another 3 bytes
-    mem = ringBuffer.allocate(3, false);
+    mem = this->ringBuffer.allocate(3, false);
     ASSERT_EQ(mem.len, 3);
-    EXPECT_EQ(ringBuffer.size(), 7);
-    ASSERT_EQ(ringBuffer.publish(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), 7);
+    ASSERT_EQ(this->ringBuffer.publish(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
   }
 
   {
     // Consume as much as possible and expect 7 bytes
-    Mem mem = ringBuffer.peek(std::numeric_limits<AtomicRingBuffer::size_type>::max(), true);
+    Mem mem = this->ringBuffer.peek(std::numeric_limits<typename TypeParam::size_type>::max(), true);
     ASSERT_EQ(mem.len, 7);
-    EXPECT_EQ(ringBuffer.size(), kBufferSize);
+    EXPECT_EQ(this->ringBuffer.size(), TestFixture::kBufferSize);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 7);
-    EXPECT_EQ(ringBuffer.size(), 3);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 7);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
 
-    mem = ringBuffer.peek(std::numeric_limits<AtomicRingBuffer::size_type>::max(), true);
+    mem = this->ringBuffer.peek(std::numeric_limits<typename TypeParam::size_type>::max(), true);
     // Consume whatever there is left.
     ASSERT_EQ(mem.len, 3);
-    EXPECT_EQ(ringBuffer.size(), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 3);
     ASSERT_NE(mem.ptr, nullptr);
-    ASSERT_EQ(ringBuffer.consume(mem), 3);
-    EXPECT_EQ(ringBuffer.size(), 0);
+    ASSERT_EQ(this->ringBuffer.consume(mem), 3);
+    EXPECT_EQ(this->ringBuffer.size(), 0);
   }
 }
 
-TEST_F(BufferedAtomicBufferFixture, MassiveData) {
+TYPED_TEST(BufferedAtomicBufferFixture, MassiveData) {
+  using Mem = typename TestFixture::Mem;
   const char* loremIpsum =
       "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Duis at dolor id nisl viverra luctus eget vitae "
       "libero. Donec ultricies, ex ac rhoncus mollis, mi ex tempus nibh, quis rutrum nulla magna id eros. Aliquam erat "
@@ -263,22 +279,84 @@ TEST_F(BufferedAtomicBufferFixture, MassiveData) {
       "a enim id leo tincidunt varius sit amet in sem. Sed aliquet tristique sem quis sodales. Nullam pellentesque "
       "purus a odio tristique venenatis.";
 
-  EXPECT_EQ(ringBuffer.capacity(), 10);
+  EXPECT_EQ(this->ringBuffer.capacity(), 10);
 
-  Mem mem = ringBuffer.allocate(strlen(loremIpsum), true);
+  Mem mem = this->ringBuffer.allocate(strlen(loremIpsum), true);
   ASSERT_EQ(mem.len, 10);
 
   {
-    Mem mem2 = ringBuffer.allocate(strlen(loremIpsum), true);
+    Mem mem2 = this->ringBuffer.allocate(strlen(loremIpsum), true);
     EXPECT_EQ(mem2.len, 0);
   }
 
   memcpy(mem.ptr, loremIpsum, 10);
 
-  EXPECT_EQ(ringBuffer.publish(mem), 10);
-  mem = ringBuffer.allocate(strlen(loremIpsum), true);
+  EXPECT_EQ(this->ringBuffer.publish(mem), 10);
+  mem = this->ringBuffer.allocate(strlen(loremIpsum), true);
   EXPECT_EQ(mem.len, 0);
-  EXPECT_EQ(ringBuffer.size(), 10);
+  EXPECT_EQ(this->ringBuffer.size(), 10);
+}
+
+// Test two-segment allocate and peek across the end of the buffer
+
+TYPED_TEST(FilledAtomicBufferFixture, AllocateSegments_Full) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
+  typename TypeParam::MemoryRangePair mem = this->ringBuffer.allocateSegments(6, false);
+  EXPECT_EQ(mem.first, (Mem{this->buffer + TestFixture::kInitialFill, 3}));
+  EXPECT_EQ(mem.second, (Mem{this->buffer, 3}));
+  EXPECT_EQ(mem.len(), 6);
+}
+
+TYPED_TEST(FilledAtomicBufferFixture, AllocateSegments_NotEnoughSpace) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
+  EXPECT_EQ(this->ringBuffer.allocateSegments(9, false), typename TypeParam::MemoryRangePair());
+
+  typename TypeParam::MemoryRangePair mem = this->ringBuffer.allocateSegments(9, true);
+  EXPECT_EQ(mem.first, (Mem{this->buffer + TestFixture::kInitialFill, 3}));
+  EXPECT_EQ(mem.second, (Mem{this->buffer, 5}));
+}
+
+TYPED_TEST(FilledAtomicBufferFixture, AllocateSegments_NoWraparound) {
+  using Mem = typename TestFixture::Mem;
+  typename TypeParam::MemoryRangePair mem = this->ringBuffer.allocateSegments(2, false);
+  EXPECT_EQ(mem.first, (Mem{this->buffer + TestFixture::kInitialFill, 2}));
+  EXPECT_EQ(mem.second, Mem());
+}
+
+TYPED_TEST(FilledAtomicBufferFixture, Segments_FullCycle) {
+  using Mem = typename TestFixture::Mem;
+  this->consume5BytesAtStart();
+  typename TypeParam::MemoryRangePair mem = this->ringBuffer.allocateSegments(6, false);
+  ASSERT_EQ(mem.len(), 6);
+  for (typename TypeParam::size_type i = 0; i < 3; ++i) {
+    mem.first.ptr[i] = static_cast<typename TypeParam::value_type>(10 + i);
+    mem.second.ptr[i] = static_cast<typename TypeParam::value_type>(13 + i);
+  }
+  EXPECT_EQ(this->ringBuffer.publish(mem), 6);
+  EXPECT_EQ(this->ringBuffer.size(), 8);
+
+  typename TypeParam::MemoryRangePair data = this->ringBuffer.peekSegments(10, true);
+  EXPECT_EQ(data.first, (Mem{this->buffer + 5, 5}));
+  EXPECT_EQ(data.second, (Mem{this->buffer, 3}));
+  EXPECT_EQ(data.first.ptr[4], 12);
+  EXPECT_EQ(data.second.ptr[0], 13);
+  EXPECT_EQ(this->ringBuffer.peekSegments(10, false), typename TypeParam::MemoryRangePair());
+
+  EXPECT_EQ(this->ringBuffer.consume(data), 8);
+  EXPECT_TRUE(this->ringBuffer.empty());
+}
+
+TYPED_TEST(FilledAtomicBufferFixture, Segments_SecondOnlyCommittedAfterFirstReachesEnd) {
+  this->consume5BytesAtStart();
+  typename TypeParam::MemoryRangePair mem = this->ringBuffer.allocateSegments(6, false);
+  ASSERT_EQ(mem.len(), 6);
+
+  // The first range does not reach the end of the buffer, so the second range is not contiguous with it.
+  mem.first.len = 2;
+  EXPECT_EQ(this->ringBuffer.publish(mem), 2);
+  EXPECT_EQ(this->ringBuffer.size(), 4);
 }
 
 }  // namespace AtomicRingBuffer